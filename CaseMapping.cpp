@@ -0,0 +1,53 @@
+#include "CaseMapping.hpp"
+
+namespace {
+    
+struct FoldTables {
+    char ascii[256];
+    char rfc1459[256];
+    
+    FoldTables() {
+        for (int i = 0; i < 256; i++) {
+            char c = static_cast<char>(i);
+            if (c >= 'A' && c <= 'Z') {
+                c = static_cast<char>(c - 'A' + 'a');
+            }
+            ascii[i] = c;
+            rfc1459[i] = c;
+        }
+        
+        rfc1459[static_cast<unsigned char>('[')] = '{';
+        rfc1459[static_cast<unsigned char>(']')] = '}';
+        rfc1459[static_cast<unsigned char>('\\')] = '|';
+        rfc1459[static_cast<unsigned char>('~')] = '^';
+    }
+};
+    
+const FoldTables foldTables;
+    
+}
+
+std::string caseFold(const std::string& name, CaseMapping mapping) {
+    const char* table = (mapping == CASEMAPPING_RFC1459) ? foldTables.rfc1459 : foldTables.ascii;
+    
+    std::string folded(name);
+    for (size_t i = 0; i < folded.length(); i++) {
+        folded[i] = table[static_cast<unsigned char>(folded[i])];
+    }
+    return folded;
+}
+
+const char* caseMappingName(CaseMapping mapping) {
+    return (mapping == CASEMAPPING_RFC1459) ? "rfc1459" : "ascii";
+}
+
+bool parseCaseMapping(const std::string& name, CaseMapping& mapping) {
+    if (name == "rfc1459") {
+        mapping = CASEMAPPING_RFC1459;
+    } else if (name == "ascii") {
+        mapping = CASEMAPPING_ASCII;
+    } else {
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,15 @@
+#ifndef CASEMAPPING_HPP
+#define CASEMAPPING_HPP
+
+#include <string>
+
+enum CaseMapping {
+    CASEMAPPING_ASCII,
+    CASEMAPPING_RFC1459
+};
+
+std::string caseFold(const std::string& name, CaseMapping mapping);
+const char* caseMappingName(CaseMapping mapping);
+bool parseCaseMapping(const std::string& name, CaseMapping& mapping);
+
+#endif
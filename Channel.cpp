@@ -4,18 +4,40 @@
 #include <sstream>
 #include <algorithm>
 
-Channel::Channel(const std::string& name) 
-    : _name(name), _topicSetTime(0), _inviteOnly(false), _topicRestricted(true), 
+Channel::Channel(const std::string& name, const std::string& foldedName, size_t reactorCount) 
+    : _name(name), _foldedName(foldedName), _topicSetTime(0), _localMembers(reactorCount), _inviteOnly(false), _topicRestricted(true), 
       _hasKey(false), _moderated(false), _noExternalMessages(true), 
-      _secret(false), _private(false), _userLimit(0), _server(NULL) {
+      _secret(false), _private(false), _userLimit(0), _server(NULL), _refCount(1), _removed(false) {
     
     time(&_creationTime);
 }
 
-Channel::~Channel() {
-    std::set<Client*> clientsCopy = _clients;
-    for (std::set<Client*>::iterator it = clientsCopy.begin(); it != clientsCopy.end(); ++it) {
-        (*it)->leaveChannel(this);
+Channel::~Channel() {}
+
+SlabPool Channel::_pool(sizeof(Channel), 64);
+
+void* Channel::operator new(size_t size) {
+    if (size != sizeof(Channel)) {
+        return ::operator new(size);
+    }
+    return _pool.allocate();
+}
+
+void Channel::operator delete(void* ptr, size_t size) {
+    if (size != sizeof(Channel)) {
+        ::operator delete(ptr);
+        return;
+    }
+    _pool.release(ptr);
+}
+
+void Channel::retain() {
+    __atomic_add_fetch(&_refCount, 1, __ATOMIC_RELAXED);
+}
+
+void Channel::release() {
+    if (__atomic_sub_fetch(&_refCount, 1, __ATOMIC_ACQ_REL) == 0) {
+        delete this;
     }
 }
 
@@ -68,6 +90,7 @@ void Channel::setUserLimit(int limit) {
 void Channel::addClient(Client* client) {
     if (client && _clients.find(client) == _clients.end()) {
         _clients.insert(client);
+        _localMembers[client->getReactor()].insert(client);
         
         if (_clients.size() == 1) {
             addOperator(client);
@@ -80,11 +103,12 @@ void Channel::addClient(Client* client) {
 void Channel::removeClient(Client* client) {
     if (client) {
         _clients.erase(client);
+        _localMembers[client->getReactor()].erase(client);
         _operators.erase(client);
-        _invited.erase(client);
+        removeInvited(client);
         
         if (_operators.empty() && !_clients.empty()) {
-            std::set<Client*>::iterator it = _clients.begin();
+            ClientSet::iterator it = _clients.begin();
             if (it != _clients.end()) {
                 addOperator(*it);
             }
@@ -114,18 +138,22 @@ bool Channel::isOperator(Client* client) const {
 
 void Channel::addInvited(Client* client) {
     if (client) {
-        _invited.insert(client);
+        _invited.insert(client->getId());
     }
 }
 
 void Channel::removeInvited(Client* client) {
     if (client) {
-        _invited.erase(client);
+        _invited.erase(client->getId());
     }
 }
 
+void Channel::clearInvites() {
+    _invited.clear();
+}
+
 bool Channel::isInvited(Client* client) const {
-    return _invited.find(client) != _invited.end();
+    return client && _invited.find(client->getId()) != _invited.end();
 }
 
 void Channel::addBanned(Client* client) {
@@ -185,11 +213,7 @@ bool Channel::canSpeak(Client* client) const {
 void Channel::broadcast(const std::string& message, Client* exclude) {
     if (!_server) return;
     
-    for (std::set<Client*>::const_iterator it = _clients.begin(); it != _clients.end(); ++it) {
-        if (*it != exclude && (*it)->getFd() >= 0) {
-            _server->sendToClient((*it)->getFd(), message);
-        }
-    }
+    _server->sendToChannel(this, message, exclude);
 }
 
 std::string Channel::getModeString() const {
@@ -221,7 +245,7 @@ std::string Channel::getModeString() const {
 std::string Channel::getNamesReply() const {
     std::string names;
     
-    for (std::set<Client*>::const_iterator it = _clients.begin(); it != _clients.end(); ++it) {
+    for (ClientSet::const_iterator it = _clients.begin(); it != _clients.end(); ++it) {
         if (!names.empty()) names += " ";
         
         if (isOperator(*it)) {
@@ -268,7 +292,7 @@ bool Channel::isValidChannelName(const std::string& name) const {
 void Channel::cleanup() {
     std::set<Client*> clientsToRemove;
     
-    for (std::set<Client*>::iterator it = _clients.begin(); it != _clients.end(); ++it) {
+    for (ClientSet::iterator it = _clients.begin(); it != _clients.end(); ++it) {
         if (!(*it)->isRegistered()) {
             clientsToRemove.insert(*it);
         }
@@ -277,15 +301,4 @@ void Channel::cleanup() {
     for (std::set<Client*>::iterator it = clientsToRemove.begin(); it != clientsToRemove.end(); ++it) {
         removeClient(*it);
     }
-    
-    std::set<Client*> invitesToRemove;
-    for (std::set<Client*>::iterator it = _invited.begin(); it != _invited.end(); ++it) {
-        if (!(*it)->isRegistered()) {
-            invitesToRemove.insert(*it);
-        }
-    }
-    
-    for (std::set<Client*>::iterator it = invitesToRemove.begin(); it != invitesToRemove.end(); ++it) {
-        _invited.erase(*it);
-    }
 }
\ No newline at end of file
@@ -4,23 +4,32 @@
 #include <string>
 #include <set>
 #include <map>
+#include <vector>
 #include <ctime>
 
+#include "SlabPool.hpp"
+#include "Mutex.hpp"
+
 class Client;
 class Server;
 
+typedef std::set<Client*> ClientSet;
+typedef std::set<unsigned long long> ClientIdSet;
+
 class Channel {
 private:
     std::string _name;
+    std::string _foldedName;
     std::string _topic;
     std::string _topicSetBy;
     time_t _topicSetTime;
     std::string _key;
     
-    std::set<Client*> _clients;
-    std::set<Client*> _operators;
-    std::set<Client*> _invited;
-    std::set<Client*> _banned;
+    ClientSet _clients;
+    std::vector<ClientSet> _localMembers;
+    ClientSet _operators;
+    ClientIdSet _invited;
+    ClientSet _banned;
     
     bool _inviteOnly;
     bool _topicRestricted;
@@ -34,24 +43,36 @@ private:
     time_t _creationTime;
     Server* _server;
     
+    Mutex _mutex;
+    size_t _refCount;
+    bool _removed;
+    
     static const size_t MAX_TOPIC_LENGTH = 307;
     static const size_t MAX_KEY_LENGTH = 23;
     static const size_t MAX_CHANNEL_NAME_LENGTH = 50;
     static const int MAX_USER_LIMIT = 999;
     
+    static SlabPool _pool;
+    
 public:
-    Channel(const std::string& name);
+    Channel(const std::string& name, const std::string& foldedName, size_t reactorCount = 1);
     ~Channel();
     
+    static void* operator new(size_t size);
+    static void operator delete(void* ptr, size_t size);
+    static SlabPool& getPool() { return _pool; }
+    
     const std::string& getName() const { return _name; }
+    const std::string& getFoldedName() const { return _foldedName; }
     const std::string& getTopic() const { return _topic; }
     const std::string& getTopicSetBy() const { return _topicSetBy; }
     time_t getTopicSetTime() const { return _topicSetTime; }
     const std::string& getKey() const { return _key; }
-    const std::set<Client*>& getClients() const { return _clients; }
-    const std::set<Client*>& getOperators() const { return _operators; }
-    const std::set<Client*>& getInvited() const { return _invited; }
-    const std::set<Client*>& getBanned() const { return _banned; }
+    const ClientSet& getClients() const { return _clients; }
+    const ClientSet& getLocalMembers(size_t reactor) const { return _localMembers[reactor]; }
+    const ClientSet& getOperators() const { return _operators; }
+    const ClientIdSet& getInvited() const { return _invited; }
+    const ClientSet& getBanned() const { return _banned; }
     
     bool isInviteOnly() const { return _inviteOnly; }
     bool isTopicRestricted() const { return _topicRestricted; }
@@ -63,6 +84,7 @@ public:
     int getUserLimit() const { return _userLimit; }
     size_t getClientCount() const { return _clients.size(); }
     time_t getCreationTime() const { return _creationTime; }
+    bool isRemoved() const { return _removed; }
     
     void setTopic(const std::string& topic, Client* setter = NULL);
     void setKey(const std::string& key);
@@ -76,6 +98,12 @@ public:
     void setUserLimit(int limit);
     void removeUserLimit() { _userLimit = 0; }
     void setServer(Server* server) { _server = server; }
+    void setRemoved(bool removed) { _removed = removed; }
+    
+    void lock() { _mutex.lock(); }
+    void unlock() { _mutex.unlock(); }
+    void retain();
+    void release();
     
     void addClient(Client* client);
     void removeClient(Client* client);
@@ -89,7 +117,7 @@ public:
     void addInvited(Client* client);
     void removeInvited(Client* client);
     bool isInvited(Client* client) const;
-    void clearInvites() { _invited.clear(); }
+    void clearInvites();
     
     void addBanned(Client* client);
     void removeBanned(Client* client);
@@ -110,4 +138,21 @@ public:
     void cleanup();
 };
 
+class ChannelLock {
+private:
+    Channel* _channel;
+    
+    ChannelLock(const ChannelLock&);
+    ChannelLock& operator=(const ChannelLock&);
+    
+public:
+    explicit ChannelLock(Channel* channel) : _channel(channel) {}
+    ~ChannelLock() {
+        if (_channel) {
+            _channel->unlock();
+            _channel->release();
+        }
+    }
+};
+
 #endif
\ No newline at end of file
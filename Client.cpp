@@ -1,30 +1,62 @@
 #include "Client.hpp"
 #include "Channel.hpp"
 #include "Server.hpp"
+#include "Payload.hpp"
 #include <sstream>
 #include <algorithm>
+#include <cstring>
 
 Client::Client(int fd, Server* server) 
-    : _fd(fd), _authenticated(false), _registered(false), 
+    : _fd(fd), _id(0), _generation(0), _reactor(0), _pendingOffset(0), _sendOffset(0), _sendQueueBytes(0), _outputInFlight(0), _pollEvents(POLLIN), _flushPending(false),
+      _sendQExceeded(false), _bytesSent(0), _messagesSent(0), _bytesReceived(0),
+      _authenticated(false), _registered(false), 
       _passwordProvided(false), _operator(false), _server(server),
-      _messageCount(0) {
+      _messageCount(0), _timerState(TIMER_REGISTRATION), _lastInput(0), _pingSentAt(0), _floodTokens(0), _floodUpdated(0), _throttled(false) {
     
     _hostname = "localhost";
     time(&_connectTime);
     _lastActivity = _connectTime;
     _lastMessageTime = _connectTime;
+    _timer.owner = this;
 }
 
 Client::~Client() {
-    std::set<Channel*> channelsCopy = _channels;
-    for (std::set<Channel*>::iterator it = channelsCopy.begin(); it != channelsCopy.end(); ++it) {
-        leaveChannel(*it);
+    _outputInFlight = 0;
+    clearOutput();
+}
+
+void* Client::operator new(size_t size, SlabPool& pool) {
+    char* slot;
+    if (size + SLOT_HEADER > pool.getSlotSize()) {
+        slot = static_cast<char*>(::operator new(size + SLOT_HEADER));
+        *reinterpret_cast<SlabPool**>(slot) = NULL;
+    } else {
+        slot = static_cast<char*>(pool.allocate());
+        *reinterpret_cast<SlabPool**>(slot) = &pool;
+    }
+    return slot + SLOT_HEADER;
+}
+
+void Client::operator delete(void* ptr, SlabPool&) {
+    operator delete(ptr);
+}
+
+void Client::operator delete(void* ptr) {
+    if (!ptr) return;
+    
+    char* slot = static_cast<char*>(ptr) - SLOT_HEADER;
+    SlabPool* pool = *reinterpret_cast<SlabPool**>(slot);
+    if (pool) {
+        pool->release(slot);
+    } else {
+        ::operator delete(slot);
     }
 }
 
 void Client::setNickname(const std::string& nickname) {
     if (isValidNickname(nickname)) {
         _nickname = nickname;
+        _foldedNickname = _server ? _server->foldName(nickname) : nickname;
         updateActivity();
     }
 }
@@ -49,66 +81,140 @@ void Client::setHostname(const std::string& hostname) {
     }
 }
 
-void Client::appendToBuffer(const std::string& data) {
-    if (_buffer.length() + data.length() > MAX_BUFFER_SIZE) {
-        _buffer.clear();
-        return;
-    }
+void Client::queueOutput(Payload* payload) {
+    payload->retain();
+    _sendQueue.push_back(payload);
+    __atomic_store_n(&_sendQueueBytes, _sendQueueBytes + payload->getSize(), __ATOMIC_RELAXED);
+}
+
+size_t Client::fillOutputVector(struct iovec* iov, size_t maxCount) const {
+    size_t count = 0;
+    size_t offset = _sendOffset;
     
-    _buffer += data;
-    updateActivity();
+    for (std::deque<Payload*>::const_iterator it = _sendQueue.begin(); it != _sendQueue.end() && count < maxCount; ++it) {
+        iov[count].iov_base = const_cast<char*>((*it)->getData() + offset);
+        iov[count].iov_len = (*it)->getSize() - offset;
+        offset = 0;
+        count++;
+    }
+    return count;
 }
 
-std::vector<std::string> Client::extractMessages() {
-    std::vector<std::string> messages;
-    size_t pos = 0;
+void Client::consumeOutput(size_t bytes) {
+    __atomic_store_n(&_sendQueueBytes, _sendQueueBytes - bytes, __ATOMIC_RELAXED);
+    __atomic_store_n(&_bytesSent, _bytesSent + bytes, __ATOMIC_RELAXED);
     
-    while ((pos = _buffer.find('\n')) != std::string::npos) {
-        std::string message = _buffer.substr(0, pos);
-        
-        if (!message.empty() && message[message.length() - 1] == '\r') {
-            message = message.substr(0, message.length() - 1);
+    while (bytes > 0 && !_sendQueue.empty()) {
+        size_t remaining = _sendQueue.front()->getSize() - _sendOffset;
+        if (bytes < remaining) {
+            _sendOffset += bytes;
+            return;
         }
         
-        if (!message.empty() && message.length() <= MAX_MESSAGE_LENGTH) {
-            messages.push_back(message);
-            incrementMessageCount();
+        bytes -= remaining;
+        _sendQueue.front()->release();
+        _sendQueue.pop_front();
+        _sendOffset = 0;
+        __atomic_store_n(&_messagesSent, _messagesSent + 1, __ATOMIC_RELAXED);
+    }
+}
+
+void Client::receiveInput(const char* data, size_t size) {
+    if (_pendingInput.empty()) {
+        size_t length = std::min(size, _inputBuffer.getWritableSize());
+        memcpy(_inputBuffer.getWritePtr(), data, length);
+        _inputBuffer.commit(length);
+        data += length;
+        size -= length;
+    }
+    if (_pendingOffset > 0 && _pendingOffset * 2 >= _pendingInput.size()) {
+        _pendingInput.erase(0, _pendingOffset);
+        _pendingOffset = 0;
+    }
+    _pendingInput.append(data, size);
+}
+
+bool Client::nextInputLine(const char*& line, size_t& length) {
+    while (!_inputBuffer.nextLine(line, length)) {
+        size_t refill = std::min(_pendingInput.size() - _pendingOffset, _inputBuffer.getWritableSize());
+        if (refill == 0) return false;
+        memcpy(_inputBuffer.getWritePtr(), _pendingInput.data() + _pendingOffset, refill);
+        _inputBuffer.commit(refill);
+        _pendingOffset += refill;
+        if (_pendingOffset == _pendingInput.size()) {
+            _pendingInput.clear();
+            _pendingOffset = 0;
         }
-        
-        _buffer = _buffer.substr(pos + 1);
     }
-    
-    if (_buffer.length() > MAX_MESSAGE_LENGTH) {
-        _buffer.clear();
+    return true;
+}
+
+void Client::clearOutput() {
+    std::deque<Payload*>::iterator first = _sendQueue.begin();
+    size_t pinned = _outputInFlight > 0 ? _sendOffset + _outputInFlight : 0;
+    while (first != _sendQueue.end() && pinned > 0) {
+        pinned -= std::min(pinned, (*first)->getSize());
+        ++first;
     }
     
-    return messages;
+    for (std::deque<Payload*>::iterator it = first; it != _sendQueue.end(); ++it) {
+        (*it)->release();
+    }
+    _sendQueue.erase(first, _sendQueue.end());
+    if (_sendQueue.empty()) _sendOffset = 0;
+    __atomic_store_n(&_sendQueueBytes, _outputInFlight, __ATOMIC_RELAXED);
 }
 
 void Client::joinChannel(Channel* channel) {
-    if (channel && _channels.find(channel) == _channels.end() && canJoinMoreChannels()) {
+    MutexLock lock(_channelsMutex);
+    
+    if (!channel) return;
+    
+    if (_channels.find(channel) == _channels.end()) {
+        if (_channels.size() >= MAX_CHANNELS) return;
         _channels.insert(channel);
-        channel->addClient(this);
-        updateActivity();
     }
+    channel->addClient(this);
+    updateActivity();
 }
 
 void Client::leaveChannel(Channel* channel) {
+    MutexLock lock(_channelsMutex);
+    
     if (channel && _channels.find(channel) != _channels.end()) {
         _channels.erase(channel);
         channel->removeClient(this);
         channel->removeOperator(this);
-        updateActivity();
     }
 }
 
+void Client::forgetChannel(Channel* channel) {
+    MutexLock lock(_channelsMutex);
+    _channels.erase(channel);
+}
+
 bool Client::isInChannel(Channel* channel) const {
+    MutexLock lock(_channelsMutex);
     return _channels.find(channel) != _channels.end();
 }
 
+bool Client::canJoinMoreChannels() const {
+    MutexLock lock(_channelsMutex);
+    return _channels.size() < MAX_CHANNELS;
+}
+
+void Client::collectChannels(std::vector<Channel*>& channels) const {
+    MutexLock lock(_channelsMutex);
+    
+    for (ChannelSet::const_iterator it = _channels.begin(); it != _channels.end(); ++it) {
+        (*it)->retain();
+        channels.push_back(*it);
+    }
+}
+
 void Client::tryRegister() {
     if (_passwordProvided && !_nickname.empty() && !_username.empty() && !_registered) {
-        _registered = true;
+        __atomic_store_n(&_registered, true, __ATOMIC_RELAXED);
         _authenticated = true;
         updateActivity();
     }
@@ -118,8 +224,20 @@ void Client::updateActivity() {
     time(&_lastActivity);
 }
 
+void Client::refillFloodTokens(double now, double rate, double burst) {
+    if (_floodUpdated == 0) {
+        _floodTokens = burst;
+    } else if (now > _floodUpdated) {
+        _floodTokens += (now - _floodUpdated) * rate;
+        if (_floodTokens > burst) {
+            _floodTokens = burst;
+        }
+    }
+    _floodUpdated = now;
+}
+
 void Client::incrementMessageCount() {
-    _messageCount++;
+    __atomic_store_n(&_messageCount, _messageCount + 1, __ATOMIC_RELAXED);
     time(&_lastMessageTime);
     updateActivity();
 }
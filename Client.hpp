@@ -4,78 +4,165 @@
 #include <string>
 #include <vector>
 #include <set>
+#include <deque>
 #include <ctime>
+#include <sys/uio.h>
+
+#include "InputBuffer.hpp"
+#include "TimerWheel.hpp"
+#include "SlabPool.hpp"
+#include "Mutex.hpp"
 
 class Channel;
 class Server;
+class Payload;
+
+typedef std::set<Channel*> ChannelSet;
+
+enum ClientTimerState {
+    TIMER_REGISTRATION,
+    TIMER_PING,
+    TIMER_AWAIT_PONG
+};
 
 class Client {
 private:
     int _fd;
+    unsigned long long _id;
+    unsigned int _generation;
+    size_t _reactor;
     std::string _nickname;
+    std::string _foldedNickname;
     std::string _username;
     std::string _realname;
     std::string _hostname;
-    std::string _buffer;
+    InputBuffer _inputBuffer;
+    std::string _pendingInput;
+    size_t _pendingOffset;
+    std::deque<Payload*> _sendQueue;
+    size_t _sendOffset;
+    size_t _sendQueueBytes;
+    size_t _outputInFlight;
+    short _pollEvents;
+    bool _flushPending;
+    bool _sendQExceeded;
+    size_t _bytesSent;
+    size_t _messagesSent;
+    size_t _bytesReceived;
     
     bool _authenticated;
     bool _registered;
     bool _passwordProvided;
     bool _operator;
     
-    std::set<Channel*> _channels;
+    ChannelSet _channels;
+    mutable Mutex _channelsMutex;
     Server* _server;
     
     time_t _connectTime;
     time_t _lastActivity;
     size_t _messageCount;
     time_t _lastMessageTime;
+    TimerNode _timer;
+    ClientTimerState _timerState;
+    double _lastInput;
+    double _pingSentAt;
+    double _floodTokens;
+    double _floodUpdated;
+    bool _throttled;
     
-    static const size_t MAX_BUFFER_SIZE = 8192;
-    static const size_t MAX_MESSAGE_LENGTH = 512;
     static const size_t MAX_CHANNELS = 20;
+    static const size_t MAX_PENDING_INPUT = 1048576;
+    static const size_t SLOT_HEADER = 2 * sizeof(void*);
     
 public:
     Client(int fd, Server* server);
     ~Client();
     
+    static void* operator new(size_t size, SlabPool& pool);
+    static void operator delete(void* ptr, SlabPool& pool);
+    static void operator delete(void* ptr);
+    static size_t getSlotSize() { return sizeof(Client) + SLOT_HEADER; }
+    
     int getFd() const { return _fd; }
+    unsigned long long getId() const { return _id; }
+    unsigned int getGeneration() const { return _generation; }
+    size_t getReactor() const { return _reactor; }
     const std::string& getNickname() const { return _nickname; }
+    const std::string& getFoldedNickname() const { return _foldedNickname; }
     const std::string& getUsername() const { return _username; }
     const std::string& getRealname() const { return _realname; }
     const std::string& getHostname() const { return _hostname; }
-    const std::string& getBuffer() const { return _buffer; }
+    InputBuffer& getInputBuffer() { return _inputBuffer; }
     bool isAuthenticated() const { return _authenticated; }
-    bool isRegistered() const { return _registered; }
+    bool isRegistered() const { return __atomic_load_n(&_registered, __ATOMIC_RELAXED); }
     bool hasPasswordProvided() const { return _passwordProvided; }
     bool isOperator() const { return _operator; }
-    const std::set<Channel*>& getChannels() const { return _channels; }
     time_t getConnectTime() const { return _connectTime; }
     time_t getLastActivity() const { return _lastActivity; }
-    size_t getMessageCount() const { return _messageCount; }
+    size_t getMessageCount() const { return __atomic_load_n(&_messageCount, __ATOMIC_RELAXED); }
     
     void setNickname(const std::string& nickname);
     void setUsername(const std::string& username);
     void setRealname(const std::string& realname);
     void setHostname(const std::string& hostname);
+    void setId(unsigned long long id) { _id = id; }
+    void setGeneration(unsigned int generation) { _generation = generation; }
+    void setReactor(size_t reactor) { _reactor = reactor; }
     void setAuthenticated(bool auth) { _authenticated = auth; }
     void setPasswordProvided(bool provided) { _passwordProvided = provided; }
     void setOperator(bool op) { _operator = op; }
     
-    void appendToBuffer(const std::string& data);
-    std::vector<std::string> extractMessages();
-    void clearBuffer() { _buffer.clear(); }
-    bool isBufferFull() const { return _buffer.length() >= MAX_BUFFER_SIZE; }
+    void clearBuffer() { _inputBuffer.clear(); }
+    bool hasPendingInput() const { return !_pendingInput.empty(); }
+    bool isInputOverflowing() const { return _pendingInput.size() - _pendingOffset > MAX_PENDING_INPUT; }
+    void receiveInput(const char* data, size_t size);
+    bool nextInputLine(const char*& line, size_t& length);
+    
+    void queueOutput(Payload* payload);
+    size_t fillOutputVector(struct iovec* iov, size_t maxCount) const;
+    bool hasPendingOutput() const { return !_sendQueue.empty(); }
+    size_t getSendQueueBytes() const { return __atomic_load_n(&_sendQueueBytes, __ATOMIC_RELAXED); }
+    size_t getBytesSent() const { return __atomic_load_n(&_bytesSent, __ATOMIC_RELAXED); }
+    size_t getMessagesSent() const { return __atomic_load_n(&_messagesSent, __ATOMIC_RELAXED); }
+    size_t getBytesReceived() const { return __atomic_load_n(&_bytesReceived, __ATOMIC_RELAXED); }
+    void addBytesReceived(size_t bytes) { __atomic_store_n(&_bytesReceived, _bytesReceived + bytes, __ATOMIC_RELAXED); }
+    bool isOutputInFlight() const { return _outputInFlight > 0; }
+    void setOutputInFlight(size_t bytes) { _outputInFlight = bytes; }
+    void consumeOutput(size_t bytes);
+    void clearOutput();
+    short getPollEvents() const { return _pollEvents; }
+    void setPollEvents(short events) { _pollEvents = events; }
+    bool isFlushPending() const { return _flushPending; }
+    void setFlushPending(bool pending) { _flushPending = pending; }
+    bool isSendQExceeded() const { return _sendQExceeded; }
+    void setSendQExceeded(bool exceeded) { _sendQExceeded = exceeded; }
     
     void joinChannel(Channel* channel);
     void leaveChannel(Channel* channel);
+    void forgetChannel(Channel* channel);
     bool isInChannel(Channel* channel) const;
-    bool canJoinMoreChannels() const { return _channels.size() < MAX_CHANNELS; }
+    bool canJoinMoreChannels() const;
+    void collectChannels(std::vector<Channel*>& channels) const;
     
     void tryRegister();
     void updateActivity();
     void incrementMessageCount();
     
+    TimerNode* getTimer() { return &_timer; }
+    ClientTimerState getTimerState() const { return _timerState; }
+    void setTimerState(ClientTimerState state) { _timerState = state; }
+    double getLastInput() const { return _lastInput; }
+    void setLastInput(double now) { _lastInput = now; }
+    double getPingSentAt() const { return _pingSentAt; }
+    void setPingSentAt(double now) { _pingSentAt = now; }
+    
+    void refillFloodTokens(double now, double rate, double burst);
+    void chargeFloodTokens(double cost) { _floodTokens -= cost; }
+    double getFloodTokens() const { return _floodTokens; }
+    bool isThrottled() const { return _throttled; }
+    void setThrottled(bool throttled) { _throttled = throttled; }
+    
     std::string getPrefix() const;
     std::string getFullIdentifier() const;
     std::string getMask() const;
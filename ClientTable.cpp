@@ -0,0 +1,72 @@
+#include "ClientTable.hpp"
+#include "Client.hpp"
+#include <sys/resource.h>
+
+ClientTable::ClientTable() : _limit(MAX_SLOTS) {
+    struct rlimit limit;
+    if (getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur != RLIM_INFINITY && limit.rlim_cur < MAX_SLOTS) {
+        _limit = static_cast<size_t>(limit.rlim_cur);
+    }
+    
+    Slot empty = { NULL, 0, 0 };
+    _slots.resize(INITIAL_SLOTS < _limit ? INITIAL_SLOTS : _limit, empty);
+}
+
+unsigned int ClientTable::getGeneration(int fd) const {
+    if (fd < 0 || static_cast<size_t>(fd) >= _slots.size()) return 0;
+    return _slots[fd].generation;
+}
+
+bool ClientTable::insert(int fd, Client* client) {
+    if (fd < 0 || static_cast<size_t>(fd) >= _limit || !client) {
+        return false;
+    }
+    
+    size_t index = static_cast<size_t>(fd);
+    if (index >= _slots.size()) {
+        size_t count = _slots.size() ? _slots.size() : INITIAL_SLOTS;
+        while (count <= index) {
+            count *= 2;
+        }
+        Slot empty = { NULL, 0, 0 };
+        _slots.resize(count < _limit ? count : _limit, empty);
+    }
+    
+    Slot& slot = _slots[index];
+    if (slot.client) {
+        return false;
+    }
+    
+    slot.client = client;
+    slot.generation++;
+    slot.position = _active.size();
+    _active.push_back(client);
+    return true;
+}
+
+bool ClientTable::erase(int fd) {
+    if (fd < 0 || static_cast<size_t>(fd) >= _slots.size()) {
+        return false;
+    }
+    
+    Slot& slot = _slots[fd];
+    if (!slot.client) {
+        return false;
+    }
+    
+    Client* last = _active.back();
+    if (last != slot.client) {
+        _active[slot.position] = last;
+        _slots[last->getFd()].position = slot.position;
+    }
+    _active.pop_back();
+    slot.client = NULL;
+    return true;
+}
+
+void ClientTable::clear() {
+    for (size_t i = 0; i < _slots.size(); i++) {
+        _slots[i].client = NULL;
+    }
+    _active.clear();
+}
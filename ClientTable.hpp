@@ -0,0 +1,56 @@
+#ifndef CLIENTTABLE_HPP
+#define CLIENTTABLE_HPP
+
+#include <vector>
+#include <cstddef>
+
+class Client;
+
+class ClientTable {
+private:
+    struct Slot {
+        Client* client;
+        unsigned int generation;
+        size_t position;
+    };
+    
+    std::vector<Slot> _slots;
+    std::vector<Client*> _active;
+    size_t _limit;
+    
+    static const size_t INITIAL_SLOTS = 64;
+    static const size_t MAX_SLOTS = 1048576;
+    
+    ClientTable(const ClientTable&);
+    ClientTable& operator=(const ClientTable&);
+    
+public:
+    typedef std::vector<Client*>::const_iterator const_iterator;
+    
+    ClientTable();
+    
+    size_t size() const { return _active.size(); }
+    bool empty() const { return _active.empty(); }
+    size_t getLimit() const { return _limit; }
+    
+    const_iterator begin() const { return _active.begin(); }
+    const_iterator end() const { return _active.end(); }
+    
+    Client* find(int fd) const {
+        if (fd < 0 || static_cast<size_t>(fd) >= _slots.size()) return NULL;
+        return _slots[fd].client;
+    }
+    
+    Client* find(int fd, unsigned int generation) const {
+        if (fd < 0 || static_cast<size_t>(fd) >= _slots.size()) return NULL;
+        const Slot& slot = _slots[fd];
+        return slot.generation == generation ? slot.client : NULL;
+    }
+    
+    unsigned int getGeneration(int fd) const;
+    bool insert(int fd, Client* client);
+    bool erase(int fd);
+    void clear();
+};
+
+#endif
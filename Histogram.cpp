@@ -0,0 +1,83 @@
+#include "Histogram.hpp"
+
+Histogram::Histogram() : _count(0), _sum(0), _max(0) {
+    for (unsigned int i = 0; i < BUCKET_COUNT; i++) {
+        _buckets[i] = 0;
+    }
+}
+
+unsigned int Histogram::_index(unsigned long long value) {
+    if (value < LINEAR_BUCKETS) {
+        return static_cast<unsigned int>(value);
+    }
+    
+    unsigned int exponent = 63 - __builtin_clzll(value);
+    unsigned int sub = static_cast<unsigned int>(value >> (exponent - SUB_BUCKET_BITS)) - SUB_BUCKETS;
+    return LINEAR_BUCKETS + (exponent - SUB_BUCKET_BITS - 1) * SUB_BUCKETS + sub;
+}
+
+unsigned long long Histogram::_upperBound(unsigned int index) {
+    if (index < LINEAR_BUCKETS) {
+        return index;
+    }
+    
+    unsigned int exponent = (index - LINEAR_BUCKETS) / SUB_BUCKETS + SUB_BUCKET_BITS + 1;
+    unsigned long long sub = (index - LINEAR_BUCKETS) % SUB_BUCKETS + SUB_BUCKETS;
+    unsigned long long width = 1ULL << (exponent - SUB_BUCKET_BITS);
+    return sub * width + (width - 1);
+}
+
+void Histogram::_add(unsigned long long* counter, unsigned long long amount) {
+    __atomic_store_n(counter, __atomic_load_n(counter, __ATOMIC_RELAXED) + amount, __ATOMIC_RELAXED);
+}
+
+void Histogram::record(unsigned long long value) {
+    _add(&_buckets[_index(value)], 1);
+    _add(&_count, 1);
+    _add(&_sum, value);
+    
+    if (value > __atomic_load_n(&_max, __ATOMIC_RELAXED)) {
+        __atomic_store_n(&_max, value, __ATOMIC_RELAXED);
+    }
+}
+
+void Histogram::merge(const Histogram& other) {
+    for (unsigned int i = 0; i < BUCKET_COUNT; i++) {
+        _add(&_buckets[i], __atomic_load_n(&other._buckets[i], __ATOMIC_RELAXED));
+    }
+    _add(&_count, other.getCount());
+    _add(&_sum, other.getSum());
+    
+    unsigned long long maximum = other.getMax();
+    if (maximum > __atomic_load_n(&_max, __ATOMIC_RELAXED)) {
+        __atomic_store_n(&_max, maximum, __ATOMIC_RELAXED);
+    }
+}
+
+unsigned long long Histogram::getMean() const {
+    unsigned long long count = getCount();
+    return count ? getSum() / count : 0;
+}
+
+unsigned long long Histogram::getPercentile(double quantile) const {
+    unsigned long long count = getCount();
+    if (count == 0) {
+        return 0;
+    }
+    
+    unsigned long long target = static_cast<unsigned long long>(quantile * count);
+    if (target >= count) {
+        target = count - 1;
+    }
+    
+    unsigned long long seen = 0;
+    for (unsigned int i = 0; i < BUCKET_COUNT; i++) {
+        seen += __atomic_load_n(&_buckets[i], __ATOMIC_RELAXED);
+        if (seen > target) {
+            unsigned long long bound = _upperBound(i);
+            unsigned long long maximum = getMax();
+            return bound < maximum ? bound : maximum;
+        }
+    }
+    return getMax();
+}
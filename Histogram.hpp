@@ -0,0 +1,36 @@
+#ifndef HISTOGRAM_HPP
+#define HISTOGRAM_HPP
+
+#include <cstddef>
+
+class Histogram {
+public:
+    static const unsigned int SUB_BUCKET_BITS = 4;
+    static const unsigned int SUB_BUCKETS = 1U << SUB_BUCKET_BITS;
+    static const unsigned int LINEAR_BUCKETS = 2 * SUB_BUCKETS;
+    static const unsigned int BUCKET_COUNT = LINEAR_BUCKETS + (64 - SUB_BUCKET_BITS - 1) * SUB_BUCKETS;
+    
+private:
+    unsigned long long _buckets[BUCKET_COUNT];
+    unsigned long long _count;
+    unsigned long long _sum;
+    unsigned long long _max;
+    
+    static unsigned int _index(unsigned long long value);
+    static unsigned long long _upperBound(unsigned int index);
+    static void _add(unsigned long long* counter, unsigned long long amount);
+    
+public:
+    Histogram();
+    
+    void record(unsigned long long value);
+    void merge(const Histogram& other);
+    
+    unsigned long long getCount() const { return __atomic_load_n(&_count, __ATOMIC_RELAXED); }
+    unsigned long long getSum() const { return __atomic_load_n(&_sum, __ATOMIC_RELAXED); }
+    unsigned long long getMax() const { return __atomic_load_n(&_max, __ATOMIC_RELAXED); }
+    unsigned long long getMean() const;
+    unsigned long long getPercentile(double quantile) const;
+};
+
+#endif
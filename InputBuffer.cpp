@@ -0,0 +1,67 @@
+#include "InputBuffer.hpp"
+#include <cstring>
+
+InputBuffer::InputBuffer() : _readPos(0), _writePos(0), _scanPos(0), _discarding(false) {}
+
+char* InputBuffer::getWritePtr() {
+    if (_readPos > 0 && _writePos == CAPACITY) {
+        memmove(_data, _data + _readPos, _writePos - _readPos);
+        _scanPos -= _readPos;
+        _writePos -= _readPos;
+        _readPos = 0;
+    }
+    return _data + _writePos;
+}
+
+size_t InputBuffer::getWritableSize() {
+    getWritePtr();
+    return CAPACITY - _writePos;
+}
+
+void InputBuffer::commit(size_t bytes) {
+    _writePos += bytes;
+}
+
+bool InputBuffer::nextLine(const char*& line, size_t& length) {
+    while (_scanPos < _writePos) {
+        const char* newline = static_cast<const char*>(memchr(_data + _scanPos, '\n', _writePos - _scanPos));
+        
+        if (!newline) {
+            _scanPos = _writePos;
+            if (_discarding || _writePos - _readPos > MAX_LINE_LENGTH) {
+                _discarding = true;
+                _readPos = _scanPos = _writePos = 0;
+            }
+            return false;
+        }
+        
+        size_t start = _readPos;
+        size_t end = static_cast<size_t>(newline - _data);
+        _readPos = _scanPos = end + 1;
+        
+        if (_discarding) {
+            _discarding = false;
+            continue;
+        }
+        
+        if (end > start && _data[end - 1] == '\r') {
+            end--;
+        }
+        
+        if (end > start && end - start <= MAX_LINE_LENGTH) {
+            line = _data + start;
+            length = end - start;
+            return true;
+        }
+    }
+    
+    if (_readPos == _writePos) {
+        _readPos = _scanPos = _writePos = 0;
+    }
+    return false;
+}
+
+void InputBuffer::clear() {
+    _readPos = _scanPos = _writePos = 0;
+    _discarding = false;
+}
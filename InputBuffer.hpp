@@ -0,0 +1,35 @@
+#ifndef INPUTBUFFER_HPP
+#define INPUTBUFFER_HPP
+
+#include <cstddef>
+
+class InputBuffer {
+public:
+    static const size_t CAPACITY = 8192;
+    static const size_t MAX_LINE_LENGTH = 512;
+    
+private:
+    char _data[CAPACITY];
+    size_t _readPos;
+    size_t _writePos;
+    size_t _scanPos;
+    bool _discarding;
+    
+    InputBuffer(const InputBuffer&);
+    InputBuffer& operator=(const InputBuffer&);
+    
+public:
+    InputBuffer();
+    
+    char* getWritePtr();
+    size_t getWritableSize();
+    void commit(size_t bytes);
+    
+    bool nextLine(const char*& line, size_t& length);
+    
+    size_t getSize() const { return _writePos - _readPos; }
+    bool isEmpty() const { return _readPos == _writePos; }
+    void clear();
+};
+
+#endif
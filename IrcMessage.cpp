@@ -0,0 +1,77 @@
+#include "IrcMessage.hpp"
+
+namespace {
+    
+Token makeToken(const char* data, size_t length) {
+    Token token;
+    token.data = data;
+    token.length = length;
+    return token;
+}
+    
+const char* skipSpaces(const char* pos, const char* end) {
+    while (pos < end && *pos == ' ') {
+        pos++;
+    }
+    return pos;
+}
+    
+const char* findSpace(const char* pos, const char* end) {
+    while (pos < end && *pos != ' ') {
+        pos++;
+    }
+    return pos;
+}
+    
+}
+
+IrcMessage::IrcMessage() : _paramCount(0), _hasTrailing(false) {
+    _tags = _prefix = _command = makeToken("", 0);
+}
+
+bool IrcMessage::parse(const char* line, size_t length) {
+    const char* pos = line;
+    const char* end = line + length;
+    
+    _tags = _prefix = _command = makeToken("", 0);
+    _paramCount = 0;
+    _hasTrailing = false;
+    
+    pos = skipSpaces(pos, end);
+    
+    if (pos < end && *pos == '@') {
+        const char* tagEnd = findSpace(pos, end);
+        _tags = makeToken(pos + 1, tagEnd - pos - 1);
+        pos = skipSpaces(tagEnd, end);
+    }
+    
+    if (pos < end && *pos == ':') {
+        const char* prefixEnd = findSpace(pos, end);
+        _prefix = makeToken(pos + 1, prefixEnd - pos - 1);
+        pos = skipSpaces(prefixEnd, end);
+    }
+    
+    const char* commandEnd = findSpace(pos, end);
+    if (commandEnd == pos) {
+        return false;
+    }
+    _command = makeToken(pos, commandEnd - pos);
+    pos = skipSpaces(commandEnd, end);
+    
+    while (pos < end && _paramCount < MAX_PARAMS) {
+        if (*pos == ':' || _paramCount == MAX_PARAMS - 1) {
+            if (*pos == ':') {
+                pos++;
+            }
+            _params[_paramCount++] = makeToken(pos, end - pos);
+            _hasTrailing = true;
+            break;
+        }
+        
+        const char* paramEnd = findSpace(pos, end);
+        _params[_paramCount++] = makeToken(pos, paramEnd - pos);
+        pos = skipSpaces(paramEnd, end);
+    }
+    
+    return true;
+}
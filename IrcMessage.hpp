@@ -0,0 +1,41 @@
+#ifndef IRCMESSAGE_HPP
+#define IRCMESSAGE_HPP
+
+#include <string>
+#include <cstddef>
+
+struct Token {
+    const char* data;
+    size_t length;
+    
+    bool empty() const { return length == 0; }
+    std::string str() const { return std::string(data, length); }
+    void assignTo(std::string& out) const { out.assign(data, length); }
+};
+
+class IrcMessage {
+public:
+    static const size_t MAX_PARAMS = 15;
+    
+private:
+    Token _tags;
+    Token _prefix;
+    Token _command;
+    Token _params[MAX_PARAMS];
+    size_t _paramCount;
+    bool _hasTrailing;
+    
+public:
+    IrcMessage();
+    
+    bool parse(const char* line, size_t length);
+    
+    const Token& getTags() const { return _tags; }
+    const Token& getPrefix() const { return _prefix; }
+    const Token& getCommand() const { return _command; }
+    const Token& getParam(size_t index) const { return _params[index]; }
+    size_t getParamCount() const { return _paramCount; }
+    bool hasTrailing() const { return _hasTrailing; }
+};
+
+#endif
@@ -0,0 +1,239 @@
+#include "Logger.hpp"
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <cstring>
+#include <cerrno>
+#include <csignal>
+#include <cstdio>
+#include <strings.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+
+const char* const Logger::_levelNames[] = { "DEBUG", "INFO", "WARNING", "ERROR", "FATAL" };
+const char* const Logger::_levelColors[] = { "\033[34m", "\033[32m", "\033[33m", "\033[31m", "\033[31m" };
+
+Logger::Logger()
+    : _queue(QUEUE_CAPACITY), _level(LOG_DEBUG), _dropped(0), _fileFd(-1), _fileSize(0),
+      _maxFileSize(10485760), _maxFiles(5), _wakePending(0), _running(false), _threadStarted(false),
+      _cachedTime(-1) {
+    
+    pthread_mutex_init(&_wakeMutex, NULL);
+    pthread_cond_init(&_wakeCond, NULL);
+    _consoleStamp[0] = '\0';
+    _fileStamp[0] = '\0';
+}
+
+Logger::~Logger() {
+    stop();
+    if (_fileFd != -1) {
+        close(_fileFd);
+    }
+    pthread_cond_destroy(&_wakeCond);
+    pthread_mutex_destroy(&_wakeMutex);
+}
+
+bool Logger::parseLevel(const std::string& name, LogLevel& level) {
+    for (size_t i = 0; i <= LOG_FATAL; i++) {
+        if (strcasecmp(name.c_str(), _levelNames[i]) == 0) {
+            level = static_cast<LogLevel>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+void Logger::log(LogLevel level, const std::string& message) {
+    if (level < _level) return;
+    
+    Record record;
+    record.time = time(NULL);
+    record.level = level;
+    record.text = new std::string(message);
+    
+    if (!_queue.push(record)) {
+        delete record.text;
+        __atomic_fetch_add(&_dropped, 1, __ATOMIC_RELAXED);
+        return;
+    }
+    
+    if (!__atomic_exchange_n(&_wakePending, 1, __ATOMIC_ACQ_REL)) {
+        pthread_mutex_lock(&_wakeMutex);
+        pthread_cond_signal(&_wakeCond);
+        pthread_mutex_unlock(&_wakeMutex);
+    }
+}
+
+void Logger::start() {
+    if (_threadStarted) return;
+    
+    _openFile();
+    _running = true;
+    
+    sigset_t blocked;
+    sigset_t previous;
+    sigemptyset(&blocked);
+    sigaddset(&blocked, SIGINT);
+    sigaddset(&blocked, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &blocked, &previous);
+    
+    _threadStarted = pthread_create(&_thread, NULL, _threadMain, this) == 0;
+    
+    pthread_sigmask(SIG_SETMASK, &previous, NULL);
+    
+    if (!_threadStarted) {
+        _running = false;
+        throw std::runtime_error("Failed to start logger thread: " + std::string(strerror(errno)));
+    }
+}
+
+void Logger::stop() {
+    if (_threadStarted) {
+        pthread_mutex_lock(&_wakeMutex);
+        _running = false;
+        pthread_cond_signal(&_wakeCond);
+        pthread_mutex_unlock(&_wakeMutex);
+        
+        pthread_join(_thread, NULL);
+        _threadStarted = false;
+    }
+    _drain();
+}
+
+void* Logger::_threadMain(void* arg) {
+    static_cast<Logger*>(arg)->_run();
+    return NULL;
+}
+
+void Logger::_run() {
+    bool running = true;
+    
+    while (running) {
+        pthread_mutex_lock(&_wakeMutex);
+        while (!__atomic_load_n(&_wakePending, __ATOMIC_ACQUIRE) && _running) {
+            pthread_cond_wait(&_wakeCond, &_wakeMutex);
+        }
+        running = _running;
+        __atomic_store_n(&_wakePending, 0, __ATOMIC_RELEASE);
+        pthread_mutex_unlock(&_wakeMutex);
+        
+        _drain();
+    }
+}
+
+void Logger::_drain() {
+    std::string console;
+    std::string file;
+    Record record;
+    
+    while (_queue.pop(record)) {
+        if (record.level >= _level) {
+            _format(record, console, file);
+        }
+        delete record.text;
+    }
+    
+    size_t dropped = __atomic_exchange_n(&_dropped, 0, __ATOMIC_ACQ_REL);
+    if (dropped > 0) {
+        std::ostringstream oss;
+        oss << dropped << " log records dropped, queue full";
+        std::string text = oss.str();
+        record.time = time(NULL);
+        record.level = LOG_WARNING;
+        record.text = &text;
+        _format(record, console, file);
+    }
+    
+    if (!console.empty()) {
+        std::cout.write(console.data(), static_cast<std::streamsize>(console.length()));
+        std::cout.flush();
+    }
+    if (!file.empty()) {
+        _writeFile(file);
+    }
+}
+
+void Logger::_format(const Record& record, std::string& console, std::string& file) {
+    if (record.time != _cachedTime) {
+        struct tm timeinfo;
+        localtime_r(&record.time, &timeinfo);
+        strftime(_consoleStamp, sizeof(_consoleStamp), "%H:%M:%S", &timeinfo);
+        strftime(_fileStamp, sizeof(_fileStamp), "%Y-%m-%d %H:%M:%S", &timeinfo);
+        _cachedTime = record.time;
+    }
+    
+    const char* level = _levelNames[record.level];
+    
+    console += _levelColors[record.level];
+    console += "[";
+    console += _consoleStamp;
+    console += "] [";
+    console += level;
+    console += "] ";
+    console += *record.text;
+    console += "\033[0m\n";
+    
+    if (_fileFd != -1) {
+        file += _fileStamp;
+        file += " [";
+        file += level;
+        file += "] ";
+        file += *record.text;
+        file += "\n";
+    }
+}
+
+void Logger::_openFile() {
+    if (_filePath.empty() || _fileFd != -1) return;
+    
+    _fileFd = open(_filePath.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+    if (_fileFd == -1) {
+        throw std::runtime_error("Failed to open log file " + _filePath + ": " + std::string(strerror(errno)));
+    }
+    fcntl(_fileFd, F_SETFD, FD_CLOEXEC);
+    
+    struct stat info;
+    _fileSize = fstat(_fileFd, &info) == 0 ? static_cast<size_t>(info.st_size) : 0;
+}
+
+void Logger::_writeFile(const std::string& data) {
+    if (_fileFd == -1) return;
+    
+    if (_maxFileSize > 0 && _fileSize > 0 && _fileSize + data.length() > _maxFileSize) {
+        _rotate();
+        if (_fileFd == -1) return;
+    }
+    
+    size_t offset = 0;
+    while (offset < data.length()) {
+        ssize_t written = write(_fileFd, data.data() + offset, data.length() - offset);
+        if (written == -1 && errno == EINTR) continue;
+        if (written <= 0) break;
+        offset += static_cast<size_t>(written);
+    }
+    _fileSize += offset;
+}
+
+void Logger::_rotate() {
+    close(_fileFd);
+    _fileFd = -1;
+    
+    if (_maxFiles == 0) {
+        unlink(_filePath.c_str());
+    }
+    for (unsigned int i = _maxFiles; i > 0; i--) {
+        std::ostringstream from;
+        std::ostringstream to;
+        from << _filePath;
+        if (i > 1) from << "." << i - 1;
+        to << _filePath << "." << i;
+        rename(from.str().c_str(), to.str().c_str());
+    }
+    
+    try {
+        _openFile();
+    } catch (const std::exception& e) {
+        log(LOG_ERROR, std::string(e.what()) + ", file logging disabled");
+    }
+}
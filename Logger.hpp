@@ -0,0 +1,81 @@
+#ifndef LOGGER_HPP
+#define LOGGER_HPP
+
+#include <string>
+#include <ctime>
+#include <pthread.h>
+
+#include "MpscQueue.hpp"
+
+enum LogLevel {
+    LOG_DEBUG,
+    LOG_INFO,
+    LOG_WARNING,
+    LOG_ERROR,
+    LOG_FATAL
+};
+
+class Logger {
+private:
+    struct Record {
+        time_t time;
+        LogLevel level;
+        std::string* text;
+    };
+    
+    MpscQueue<Record> _queue;
+    LogLevel _level;
+    size_t _dropped;
+    
+    std::string _filePath;
+    int _fileFd;
+    size_t _fileSize;
+    size_t _maxFileSize;
+    unsigned int _maxFiles;
+    
+    pthread_mutex_t _wakeMutex;
+    pthread_cond_t _wakeCond;
+    int _wakePending;
+    bool _running;
+    pthread_t _thread;
+    bool _threadStarted;
+    
+    time_t _cachedTime;
+    char _consoleStamp[16];
+    char _fileStamp[32];
+    
+    static const size_t QUEUE_CAPACITY = 16384;
+    static const char* const _levelNames[];
+    static const char* const _levelColors[];
+    
+    static void* _threadMain(void* arg);
+    void _run();
+    void _drain();
+    void _format(const Record& record, std::string& console, std::string& file);
+    void _openFile();
+    void _writeFile(const std::string& data);
+    void _rotate();
+    
+    Logger(const Logger&);
+    Logger& operator=(const Logger&);
+    
+public:
+    Logger();
+    ~Logger();
+    
+    LogLevel getLevel() const { return _level; }
+    bool isEnabled(LogLevel level) const { return level >= _level; }
+    
+    void setLevel(LogLevel level) { _level = level; }
+    void setFile(const std::string& path) { _filePath = path; }
+    void setMaxFileSize(size_t bytes) { _maxFileSize = bytes; }
+    void setMaxFiles(unsigned int count) { _maxFiles = count; }
+    
+    void log(LogLevel level, const std::string& message);
+    void start();
+    void stop();
+    
+    static bool parseLevel(const std::string& name, LogLevel& level);
+};
+
+#endif
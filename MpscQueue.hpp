@@ -0,0 +1,78 @@
+#ifndef MPSCQUEUE_HPP
+#define MPSCQUEUE_HPP
+
+#include <vector>
+#include <cstddef>
+
+template <typename T>
+class MpscQueue {
+private:
+    struct Cell {
+        size_t sequence;
+        T value;
+    };
+    
+    std::vector<Cell> _cells;
+    size_t _mask;
+    char _padding[64];
+    size_t _enqueuePos;
+    char _consumerPadding[64];
+    size_t _dequeuePos;
+    
+    MpscQueue(const MpscQueue&);
+    MpscQueue& operator=(const MpscQueue&);
+    
+public:
+    explicit MpscQueue(size_t capacity) : _enqueuePos(0), _dequeuePos(0) {
+        size_t size = 2;
+        while (size < capacity) {
+            size <<= 1;
+        }
+        
+        _cells.resize(size);
+        _mask = size - 1;
+        for (size_t i = 0; i < size; i++) {
+            _cells[i].sequence = i;
+        }
+    }
+    
+    size_t capacity() const { return _cells.size(); }
+    
+    bool push(const T& value) {
+        size_t pos = __atomic_load_n(&_enqueuePos, __ATOMIC_RELAXED);
+        Cell* cell;
+        
+        for (;;) {
+            cell = &_cells[pos & _mask];
+            size_t sequence = __atomic_load_n(&cell->sequence, __ATOMIC_ACQUIRE);
+            
+            if (sequence == pos) {
+                if (__atomic_compare_exchange_n(&_enqueuePos, &pos, pos + 1, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                    break;
+                }
+            } else if (sequence < pos) {
+                return false;
+            } else {
+                pos = __atomic_load_n(&_enqueuePos, __ATOMIC_RELAXED);
+            }
+        }
+        
+        cell->value = value;
+        __atomic_store_n(&cell->sequence, pos + 1, __ATOMIC_RELEASE);
+        return true;
+    }
+    
+    bool pop(T& value) {
+        Cell* cell = &_cells[_dequeuePos & _mask];
+        if (__atomic_load_n(&cell->sequence, __ATOMIC_ACQUIRE) != _dequeuePos + 1) {
+            return false;
+        }
+        
+        value = cell->value;
+        __atomic_store_n(&cell->sequence, _dequeuePos + _mask + 1, __ATOMIC_RELEASE);
+        _dequeuePos++;
+        return true;
+    }
+};
+
+#endif
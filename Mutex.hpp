@@ -0,0 +1,82 @@
+#ifndef MUTEX_HPP
+#define MUTEX_HPP
+
+#include <pthread.h>
+
+class Mutex {
+private:
+    pthread_mutex_t _mutex;
+    
+    Mutex(const Mutex&);
+    Mutex& operator=(const Mutex&);
+    
+public:
+    explicit Mutex(bool recursive = false) {
+        pthread_mutexattr_t attr;
+        pthread_mutexattr_init(&attr);
+        if (recursive) {
+            pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+        }
+        pthread_mutex_init(&_mutex, &attr);
+        pthread_mutexattr_destroy(&attr);
+    }
+    
+    ~Mutex() { pthread_mutex_destroy(&_mutex); }
+    
+    void lock() { pthread_mutex_lock(&_mutex); }
+    void unlock() { pthread_mutex_unlock(&_mutex); }
+};
+
+class MutexLock {
+private:
+    Mutex& _mutex;
+    
+    MutexLock(const MutexLock&);
+    MutexLock& operator=(const MutexLock&);
+    
+public:
+    explicit MutexLock(Mutex& mutex) : _mutex(mutex) { _mutex.lock(); }
+    ~MutexLock() { _mutex.unlock(); }
+};
+
+class RwLock {
+private:
+    pthread_rwlock_t _lock;
+    
+    RwLock(const RwLock&);
+    RwLock& operator=(const RwLock&);
+    
+public:
+    RwLock() { pthread_rwlock_init(&_lock, NULL); }
+    ~RwLock() { pthread_rwlock_destroy(&_lock); }
+    
+    void readLock() { pthread_rwlock_rdlock(&_lock); }
+    void writeLock() { pthread_rwlock_wrlock(&_lock); }
+    void unlock() { pthread_rwlock_unlock(&_lock); }
+};
+
+class ReadLock {
+private:
+    RwLock& _lock;
+    
+    ReadLock(const ReadLock&);
+    ReadLock& operator=(const ReadLock&);
+    
+public:
+    explicit ReadLock(RwLock& lock) : _lock(lock) { _lock.readLock(); }
+    ~ReadLock() { _lock.unlock(); }
+};
+
+class WriteLock {
+private:
+    RwLock& _lock;
+    
+    WriteLock(const WriteLock&);
+    WriteLock& operator=(const WriteLock&);
+    
+public:
+    explicit WriteLock(RwLock& lock) : _lock(lock) { _lock.writeLock(); }
+    ~WriteLock() { _lock.unlock(); }
+};
+
+#endif
@@ -0,0 +1,157 @@
+#ifndef NAMEINDEX_HPP
+#define NAMEINDEX_HPP
+
+#include <string>
+#include <vector>
+#include <cstddef>
+
+template <typename T>
+class NameIndex {
+private:
+    struct Node {
+        std::string key;
+        size_t hash;
+        T* value;
+        Node* next;
+    };
+    
+    std::vector<Node*> _buckets;
+    size_t _size;
+    
+    static const size_t INITIAL_BUCKETS = 64;
+    
+    static size_t _hash(const std::string& key) {
+        size_t hash = 2166136261u;
+        for (size_t i = 0; i < key.length(); i++) {
+            hash ^= static_cast<unsigned char>(key[i]);
+            hash *= 16777619u;
+        }
+        return hash;
+    }
+    
+    void _rehash(size_t bucketCount) {
+        std::vector<Node*> buckets(bucketCount, static_cast<Node*>(NULL));
+        
+        for (size_t i = 0; i < _buckets.size(); i++) {
+            Node* node = _buckets[i];
+            while (node) {
+                Node* next = node->next;
+                size_t index = node->hash & (bucketCount - 1);
+                node->next = buckets[index];
+                buckets[index] = node;
+                node = next;
+            }
+        }
+        
+        _buckets.swap(buckets);
+    }
+    
+    NameIndex(const NameIndex&);
+    NameIndex& operator=(const NameIndex&);
+    
+public:
+    class const_iterator {
+    private:
+        const std::vector<Node*>* _buckets;
+        size_t _bucket;
+        Node* _node;
+        
+        void _skipEmpty() {
+            while (!_node && _bucket < _buckets->size()) {
+                _node = (*_buckets)[_bucket++];
+            }
+        }
+    
+    public:
+        const_iterator(const std::vector<Node*>* buckets, size_t bucket)
+            : _buckets(buckets), _bucket(bucket), _node(NULL) { _skipEmpty(); }
+        
+        const std::string& key() const { return _node->key; }
+        T* value() const { return _node->value; }
+        
+        const_iterator& operator++() {
+            _node = _node->next;
+            _skipEmpty();
+            return *this;
+        }
+        
+        bool operator==(const const_iterator& other) const { return _node == other._node; }
+        bool operator!=(const const_iterator& other) const { return _node != other._node; }
+    };
+    
+    NameIndex() : _buckets(INITIAL_BUCKETS, static_cast<Node*>(NULL)), _size(0) {}
+    
+    ~NameIndex() { clear(); }
+    
+    size_t size() const { return _size; }
+    bool empty() const { return _size == 0; }
+    
+    const_iterator begin() const { return const_iterator(&_buckets, 0); }
+    const_iterator end() const { return const_iterator(&_buckets, _buckets.size()); }
+    
+    T* find(const std::string& key) const {
+        size_t hash = _hash(key);
+        for (Node* node = _buckets[hash & (_buckets.size() - 1)]; node; node = node->next) {
+            if (node->hash == hash && node->key == key) {
+                return node->value;
+            }
+        }
+        return NULL;
+    }
+    
+    bool insert(const std::string& key, T* value) {
+        size_t hash = _hash(key);
+        size_t index = hash & (_buckets.size() - 1);
+        
+        for (Node* node = _buckets[index]; node; node = node->next) {
+            if (node->hash == hash && node->key == key) {
+                return false;
+            }
+        }
+        
+        Node* node = new Node;
+        node->key = key;
+        node->hash = hash;
+        node->value = value;
+        node->next = _buckets[index];
+        _buckets[index] = node;
+        _size++;
+        
+        if (_size > _buckets.size()) {
+            _rehash(_buckets.size() * 2);
+        }
+        return true;
+    }
+    
+    bool erase(const std::string& key) {
+        size_t hash = _hash(key);
+        Node** link = &_buckets[hash & (_buckets.size() - 1)];
+        
+        while (*link) {
+            Node* node = *link;
+            if (node->hash == hash && node->key == key) {
+                *link = node->next;
+                delete node;
+                _size--;
+                return true;
+            }
+            link = &node->next;
+        }
+        return false;
+    }
+    
+    void clear() {
+        for (size_t i = 0; i < _buckets.size(); i++) {
+            Node* node = _buckets[i];
+            while (node) {
+                Node* next = node->next;
+                delete node;
+                node = next;
+            }
+            _buckets[i] = NULL;
+        }
+        _size = 0;
+    }
+};
+
+#endif
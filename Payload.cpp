@@ -0,0 +1,30 @@
+#include "Payload.hpp"
+#include <cstring>
+#include <new>
+
+Payload::Payload(size_t size) : _refCount(1), _size(size) {}
+
+Payload::~Payload() {}
+
+Payload* Payload::create(const std::string& line) {
+    size_t size = line.length() + 2;
+    void* memory = ::operator new(sizeof(Payload) + size);
+    Payload* payload = new (memory) Payload(size);
+
+    char* data = reinterpret_cast<char*>(payload + 1);
+    memcpy(data, line.data(), line.length());
+    data[size - 2] = '\r';
+    data[size - 1] = '\n';
+    return payload;
+}
+
+void Payload::retain() {
+    __atomic_add_fetch(&_refCount, 1, __ATOMIC_RELAXED);
+}
+
+void Payload::release() {
+    if (__atomic_sub_fetch(&_refCount, 1, __ATOMIC_ACQ_REL) == 0) {
+        this->~Payload();
+        ::operator delete(this);
+    }
+}
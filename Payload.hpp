@@ -0,0 +1,29 @@
+#ifndef PAYLOAD_HPP
+#define PAYLOAD_HPP
+
+#include <string>
+#include <cstddef>
+
+class Payload {
+private:
+    size_t _refCount;
+    size_t _size;
+
+    explicit Payload(size_t size);
+    ~Payload();
+
+    Payload(const Payload&);
+    Payload& operator=(const Payload&);
+
+public:
+    static Payload* create(const std::string& line);
+
+    void retain();
+    void release();
+
+    const char* getData() const { return reinterpret_cast<const char*>(this + 1); }
+    size_t getSize() const { return _size; }
+    size_t getRefCount() const { return _refCount; }
+};
+
+#endif
@@ -0,0 +1,812 @@
+#include "Poller.hpp"
+#include <stdexcept>
+#include <cstring>
+#include <algorithm>
+#include <cerrno>
+#include <unistd.h>
+
+#if defined(__linux__) && defined(USE_IO_URING)
+#include <cstddef>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#endif
+
+static PollerEvent makeEvent(PollerEventType type, int fd, short events, int result, const char* data) {
+    PollerEvent event;
+    event.type = type;
+    event.fd = fd;
+    event.events = events;
+    event.result = result;
+    event.data = data;
+    return event;
+}
+
+Poller* Poller::create(const std::string& backend) {
+#if defined(__linux__) && defined(USE_IO_URING)
+    if (backend == "io_uring") {
+        try {
+            return new IoUringPoller();
+        } catch (const std::runtime_error& e) {
+            return create("epoll");
+        }
+    }
+#endif
+#ifdef __linux__
+    if (backend == "epoll" || backend == "epoll-et" || backend == "io_uring") {
+        try {
+            return new EpollPoller(backend == "epoll-et");
+        } catch (const std::runtime_error& e) {
+            return new PollPoller();
+        }
+    }
+#endif
+    (void)backend;
+    return new PollPoller();
+}
+
+bool Poller::isValidBackend(const std::string& backend) {
+    return backend == "poll" || backend == "epoll" || backend == "epoll-et" || backend == "io_uring";
+}
+
+PollPoller::PollPoller() {}
+
+PollPoller::~PollPoller() {}
+
+bool PollPoller::add(int fd, short events) {
+    if (fd < 0) return false;
+    
+    if (static_cast<size_t>(fd) >= _slots.size()) {
+        _slots.resize(fd + 1, -1);
+    }
+    
+    if (_slots[fd] != -1) {
+        return modify(fd, events);
+    }
+    
+    struct pollfd pfd;
+    pfd.fd = fd;
+    pfd.events = events;
+    pfd.revents = 0;
+    _slots[fd] = static_cast<int>(_pollFds.size());
+    _pollFds.push_back(pfd);
+    return true;
+}
+
+bool PollPoller::modify(int fd, short events) {
+    if (fd < 0 || static_cast<size_t>(fd) >= _slots.size() || _slots[fd] == -1) {
+        return false;
+    }
+    
+    _pollFds[_slots[fd]].events = events;
+    return true;
+}
+
+void PollPoller::remove(int fd) {
+    if (fd < 0 || static_cast<size_t>(fd) >= _slots.size() || _slots[fd] == -1) {
+        return;
+    }
+    
+    int slot = _slots[fd];
+    int last = static_cast<int>(_pollFds.size()) - 1;
+    
+    if (slot != last) {
+        _pollFds[slot] = _pollFds[last];
+        _slots[_pollFds[slot].fd] = slot;
+    }
+    
+    _pollFds.pop_back();
+    _slots[fd] = -1;
+}
+
+int PollPoller::wait(std::vector<PollerEvent>& ready, int timeoutMs) {
+    ready.clear();
+    
+    int result = poll(_pollFds.data(), _pollFds.size(), timeoutMs);
+    if (result <= 0) {
+        return result;
+    }
+    
+    for (size_t i = 0; i < _pollFds.size() && ready.size() < static_cast<size_t>(result); i++) {
+        if (_pollFds[i].revents != 0) {
+            ready.push_back(makeEvent(POLLER_READY, _pollFds[i].fd, _pollFds[i].revents, 0, NULL));
+        }
+    }
+    
+    return static_cast<int>(ready.size());
+}
+
+#ifdef __linux__
+
+EpollPoller::EpollPoller(bool edgeTriggered)
+    : _epollFd(-1), _edgeTriggered(edgeTriggered), _events(256) {
+    
+    _epollFd = epoll_create1(EPOLL_CLOEXEC);
+    if (_epollFd == -1) {
+        throw std::runtime_error("Failed to create epoll instance: " + std::string(strerror(errno)));
+    }
+}
+
+EpollPoller::~EpollPoller() {
+    if (_epollFd != -1) {
+        close(_epollFd);
+    }
+}
+
+unsigned int EpollPoller::_toEpoll(short events) const {
+    unsigned int result = 0;
+    if (events & POLLIN) result |= EPOLLIN;
+    if (events & POLLOUT) result |= EPOLLOUT;
+    if (_edgeTriggered) result |= EPOLLET;
+    return result;
+}
+
+short EpollPoller::_fromEpoll(unsigned int events) const {
+    short result = 0;
+    if (events & EPOLLIN) result |= POLLIN;
+    if (events & EPOLLOUT) result |= POLLOUT;
+    if (events & EPOLLERR) result |= POLLERR;
+    if (events & EPOLLHUP) result |= POLLHUP;
+    return result;
+}
+
+bool EpollPoller::add(int fd, short events) {
+    struct epoll_event ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.events = _toEpoll(events);
+    ev.data.fd = fd;
+    return epoll_ctl(_epollFd, EPOLL_CTL_ADD, fd, &ev) == 0;
+}
+
+bool EpollPoller::modify(int fd, short events) {
+    struct epoll_event ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.events = _toEpoll(events);
+    ev.data.fd = fd;
+    return epoll_ctl(_epollFd, EPOLL_CTL_MOD, fd, &ev) == 0;
+}
+
+void EpollPoller::remove(int fd) {
+    struct epoll_event ev;
+    memset(&ev, 0, sizeof(ev));
+    epoll_ctl(_epollFd, EPOLL_CTL_DEL, fd, &ev);
+}
+
+int EpollPoller::wait(std::vector<PollerEvent>& ready, int timeoutMs) {
+    ready.clear();
+    
+    int result = epoll_wait(_epollFd, _events.data(), static_cast<int>(_events.size()), timeoutMs);
+    if (result <= 0) {
+        return result;
+    }
+    
+    for (int i = 0; i < result; i++) {
+        ready.push_back(makeEvent(POLLER_READY, _events[i].data.fd, _fromEpoll(_events[i].events), 0, NULL));
+    }
+    
+    if (static_cast<size_t>(result) == _events.size()) {
+        _events.resize(_events.size() * 2);
+    }
+    
+    return result;
+}
+
+#endif
+
+#if defined(__linux__) && defined(USE_IO_URING)
+
+IoUringPoller::IoUringPoller()
+    : _ringFd(-1), _sqRing(MAP_FAILED), _sqRingSize(0), _cqRing(MAP_FAILED), _cqRingSize(0),
+      _sqes(static_cast<struct io_uring_sqe*>(MAP_FAILED)), _sqesSize(0),
+      _bufRing(static_cast<struct io_uring_buf*>(MAP_FAILED)), _bufRingTail(NULL), _bufTail(0), _buffers(NULL),
+      _multishotRecv(true) {
+    
+    struct io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    
+    _ringFd = static_cast<int>(syscall(__NR_io_uring_setup, RING_ENTRIES, &params));
+    if (_ringFd == -1) {
+        throw std::runtime_error("Failed to create io_uring instance: " + std::string(strerror(errno)));
+    }
+    
+    if (!(params.features & IORING_FEAT_EXT_ARG) || !(params.features & IORING_FEAT_NODROP)) {
+        _release();
+        throw std::runtime_error("io_uring lacks IORING_FEAT_EXT_ARG or IORING_FEAT_NODROP support");
+    }
+    
+    _sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned int);
+    _cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    bool singleMmap = params.features & IORING_FEAT_SINGLE_MMAP;
+    if (singleMmap) {
+        _sqRingSize = std::max(_sqRingSize, _cqRingSize);
+        _cqRingSize = _sqRingSize;
+    }
+    
+    _sqRing = mmap(NULL, _sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _ringFd, IORING_OFF_SQ_RING);
+    if (_sqRing != MAP_FAILED) {
+        _cqRing = singleMmap ? _sqRing : mmap(NULL, _cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _ringFd, IORING_OFF_CQ_RING);
+    }
+    _sqesSize = params.sq_entries * sizeof(struct io_uring_sqe);
+    if (_cqRing != MAP_FAILED) {
+        _sqes = static_cast<struct io_uring_sqe*>(mmap(NULL, _sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _ringFd, IORING_OFF_SQES));
+    }
+    if (_sqes == MAP_FAILED) {
+        std::string error = strerror(errno);
+        _release();
+        throw std::runtime_error("Failed to map io_uring rings: " + error);
+    }
+    
+    char* sq = static_cast<char*>(_sqRing);
+    _sqHead = reinterpret_cast<unsigned int*>(sq + params.sq_off.head);
+    _sqTail = reinterpret_cast<unsigned int*>(sq + params.sq_off.tail);
+    _sqArray = reinterpret_cast<unsigned int*>(sq + params.sq_off.array);
+    _sqMask = *reinterpret_cast<unsigned int*>(sq + params.sq_off.ring_mask);
+    _sqEntries = params.sq_entries;
+    
+    char* cq = static_cast<char*>(_cqRing);
+    _cqHead = reinterpret_cast<unsigned int*>(cq + params.cq_off.head);
+    _cqTail = reinterpret_cast<unsigned int*>(cq + params.cq_off.tail);
+    _cqes = reinterpret_cast<struct io_uring_cqe*>(cq + params.cq_off.cqes);
+    _cqMask = *reinterpret_cast<unsigned int*>(cq + params.cq_off.ring_mask);
+    
+    _setupBuffers();
+}
+
+IoUringPoller::~IoUringPoller() {
+    _release();
+}
+
+void IoUringPoller::_setupBuffers() {
+    size_t ringSize = BUFFER_COUNT * sizeof(struct io_uring_buf);
+    _bufRing = static_cast<struct io_uring_buf*>(mmap(NULL, ringSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+    if (_bufRing == MAP_FAILED) {
+        std::string error = strerror(errno);
+        _release();
+        throw std::runtime_error("Failed to map io_uring buffer ring: " + error);
+    }
+    _bufRingTail = reinterpret_cast<unsigned short*>(reinterpret_cast<char*>(_bufRing) + offsetof(struct io_uring_buf, resv));
+    
+    struct io_uring_buf_reg reg;
+    memset(&reg, 0, sizeof(reg));
+    reg.ring_addr = reinterpret_cast<unsigned long long>(_bufRing);
+    reg.ring_entries = BUFFER_COUNT;
+    reg.bgid = BUFFER_GROUP;
+    if (syscall(__NR_io_uring_register, _ringFd, IORING_REGISTER_PBUF_RING, &reg, 1) == -1) {
+        std::string error = strerror(errno);
+        _release();
+        throw std::runtime_error("Failed to register io_uring buffer ring: " + error);
+    }
+    
+    _buffers = new char[BUFFER_COUNT * BUFFER_SIZE];
+    for (unsigned int bid = 0; bid < BUFFER_COUNT; bid++) {
+        _recycleBuffer(static_cast<unsigned short>(bid));
+    }
+}
+
+void IoUringPoller::_release() {
+    if (_sqes != MAP_FAILED) {
+        munmap(_sqes, _sqesSize);
+    }
+    if (_cqRing != MAP_FAILED && _cqRing != _sqRing) {
+        munmap(_cqRing, _cqRingSize);
+    }
+    if (_sqRing != MAP_FAILED) {
+        munmap(_sqRing, _sqRingSize);
+    }
+    if (_ringFd != -1) {
+        close(_ringFd);
+    }
+    if (_bufRing != MAP_FAILED) {
+        munmap(_bufRing, BUFFER_COUNT * sizeof(struct io_uring_buf));
+    }
+    delete[] _buffers;
+    for (size_t i = 0; i < _sendBuffers.size(); i++) {
+        delete _sendBuffers[i];
+    }
+}
+
+int IoUringPoller::_enter(unsigned int toSubmit, unsigned int minComplete, unsigned int flags, void* arg, size_t argSize) {
+    return static_cast<int>(syscall(__NR_io_uring_enter, _ringFd, toSubmit, minComplete, flags, arg, argSize));
+}
+
+unsigned int IoUringPoller::_unsubmitted() const {
+    return *_sqTail - __atomic_load_n(_sqHead, __ATOMIC_ACQUIRE);
+}
+
+struct io_uring_sqe* IoUringPoller::_nextSqe() {
+    if (_unsubmitted() >= _sqEntries) {
+        _enter(_unsubmitted(), 0, 0, NULL, 0);
+        if (_unsubmitted() >= _sqEntries) {
+            return NULL;
+        }
+    }
+    
+    unsigned int tail = *_sqTail;
+    unsigned int index = tail & _sqMask;
+    struct io_uring_sqe* sqe = &_sqes[index];
+    
+    memset(sqe, 0, sizeof(*sqe));
+    _sqArray[index] = index;
+    __atomic_store_n(_sqTail, tail + 1, __ATOMIC_RELEASE);
+    return sqe;
+}
+
+unsigned long long IoUringPoller::_key(Operation op, int fd, unsigned int generation) const {
+    return (static_cast<unsigned long long>(op) << 56)
+        | (static_cast<unsigned long long>(generation & 0xffffff) << 32)
+        | static_cast<unsigned int>(fd);
+}
+
+void IoUringPoller::_recycleBuffer(unsigned short bid) {
+    struct io_uring_buf& buf = _bufRing[_bufTail & (BUFFER_COUNT - 1)];
+    buf.addr = reinterpret_cast<unsigned long long>(_buffers + static_cast<size_t>(bid) * BUFFER_SIZE);
+    buf.len = BUFFER_SIZE;
+    buf.bid = bid;
+    _bufTail++;
+    __atomic_store_n(_bufRingTail, _bufTail, __ATOMIC_RELEASE);
+}
+
+void IoUringPoller::_arm(int fd) {
+    if (!_armSend(fd) || !_armRead(fd)) {
+        _scheduleArm(fd);
+    }
+}
+
+bool IoUringPoller::_armSend(int fd) {
+    Interest& interest = _interests[fd];
+    if (interest.sending == -1 || interest.sendArmed) return true;
+    
+    struct io_uring_sqe* sqe = _nextSqe();
+    if (!sqe) return false;
+    
+    SendBuffer* buffer = _sendBuffers[interest.sending];
+    memset(&buffer->message, 0, sizeof(buffer->message));
+    buffer->message.msg_iov = &buffer->iov[0];
+    buffer->message.msg_iovlen = buffer->iov.size();
+    sqe->opcode = IORING_OP_SENDMSG;
+    sqe->fd = fd;
+    sqe->addr = reinterpret_cast<unsigned long long>(&buffer->message);
+    sqe->len = 1;
+    sqe->msg_flags = MSG_NOSIGNAL;
+    sqe->user_data = _key(OP_SEND, interest.sending, interest.generation);
+    interest.sendArmed = true;
+    return true;
+}
+
+bool IoUringPoller::_armRead(int fd) {
+    Interest& interest = _interests[fd];
+    if (interest.streaming && !(interest.events & POLLIN)) {
+        if (interest.watching) return true;
+        
+        struct io_uring_sqe* sqe = _nextSqe();
+        if (!sqe) return false;
+        
+        sqe->opcode = IORING_OP_POLL_ADD;
+        sqe->fd = fd;
+        sqe->user_data = _key(OP_POLL, fd, interest.generation);
+        interest.watching = true;
+        return true;
+    }
+    
+    if (interest.armed || (!interest.listening && !interest.streaming && interest.events == 0)) return true;
+    
+    struct io_uring_sqe* sqe = _nextSqe();
+    if (!sqe) return false;
+    
+    sqe->fd = fd;
+    if (interest.listening) {
+        sqe->opcode = IORING_OP_ACCEPT;
+        sqe->ioprio = IORING_ACCEPT_MULTISHOT;
+        sqe->accept_flags = SOCK_NONBLOCK | SOCK_CLOEXEC;
+        sqe->user_data = _key(OP_ACCEPT, fd, interest.generation);
+    } else if (interest.streaming) {
+        sqe->opcode = IORING_OP_RECV;
+        sqe->flags = IOSQE_BUFFER_SELECT;
+        sqe->buf_group = BUFFER_GROUP;
+        if (_multishotRecv) {
+            sqe->ioprio = IORING_RECV_MULTISHOT;
+        } else {
+            sqe->len = BUFFER_SIZE;
+        }
+        sqe->user_data = _key(OP_RECV, fd, interest.generation);
+    } else {
+        sqe->opcode = IORING_OP_POLL_ADD;
+        sqe->poll32_events = static_cast<unsigned short>(interest.events);
+        sqe->user_data = _key(OP_POLL, fd, interest.generation);
+    }
+    interest.armed = true;
+    return true;
+}
+
+void IoUringPoller::_scheduleArm(int fd) {
+    if (!_interests[fd].queued) {
+        _interests[fd].queued = true;
+        _rearm.push_back(fd);
+    }
+}
+
+IoUringPoller::Interest& IoUringPoller::_register(int fd) {
+    if (static_cast<size_t>(fd) >= _interests.size()) {
+        Interest empty;
+        memset(&empty, 0, sizeof(empty));
+        empty.sending = -1;
+        _interests.resize(fd + 1, empty);
+    }
+    
+    Interest& interest = _interests[fd];
+    interest.registered = true;
+    interest.listening = false;
+    interest.streaming = false;
+    interest.armed = false;
+    interest.watching = false;
+    interest.sendArmed = false;
+    interest.sending = -1;
+    interest.generation++;
+    _scheduleArm(fd);
+    return interest;
+}
+
+int IoUringPoller::_takeSendBuffer(int fd) {
+    int index;
+    if (_freeSendBuffers.empty()) {
+        index = static_cast<int>(_sendBuffers.size());
+        _sendBuffers.push_back(new SendBuffer());
+    } else {
+        index = _freeSendBuffers.back();
+        _freeSendBuffers.pop_back();
+    }
+    
+    _sendBuffers[index]->fd = fd;
+    return index;
+}
+
+void IoUringPoller::_releaseSendBuffer(int index) {
+    SendBuffer* buffer = _sendBuffers[index];
+    buffer->fd = -1;
+    buffer->iov.clear();
+    _freeSendBuffers.push_back(index);
+}
+
+void IoUringPoller::_flushDirect(int index) {
+    SendBuffer* buffer = _sendBuffers[index];
+    size_t first = 0;
+    while (first < buffer->iov.size()) {
+        memset(&buffer->message, 0, sizeof(buffer->message));
+        buffer->message.msg_iov = &buffer->iov[first];
+        buffer->message.msg_iovlen = buffer->iov.size() - first;
+        ssize_t sent = sendmsg(buffer->fd, &buffer->message, MSG_DONTWAIT | MSG_NOSIGNAL);
+        if (sent == -1 && errno == EINTR) continue;
+        if (sent <= 0) break;
+        
+        size_t remaining = static_cast<size_t>(sent);
+        while (first < buffer->iov.size() && remaining >= buffer->iov[first].iov_len) {
+            remaining -= buffer->iov[first].iov_len;
+            first++;
+        }
+        if (remaining > 0) {
+            buffer->iov[first].iov_base = static_cast<char*>(buffer->iov[first].iov_base) + remaining;
+            buffer->iov[first].iov_len -= remaining;
+        }
+    }
+}
+
+void IoUringPoller::_awaitSend(int fd) {
+    Interest& interest = _interests[fd];
+    unsigned long long key = _key(OP_SEND, interest.sending, interest.generation);
+    bool cancelled = false;
+    bool completed = false;
+    
+    for (size_t i = 0; i < _backlog.size() && !completed; i++) {
+        if (_backlog[i].user_data == key) {
+            _backlog.erase(_backlog.begin() + i);
+            completed = true;
+        }
+    }
+    
+    while (!completed) {
+        if (!cancelled) {
+            struct io_uring_sqe* sqe = _nextSqe();
+            if (sqe) {
+                sqe->opcode = IORING_OP_ASYNC_CANCEL;
+                sqe->fd = -1;
+                sqe->addr = key;
+                sqe->user_data = _key(OP_CANCEL, fd, 0);
+                cancelled = true;
+            }
+        }
+        
+        if (_enter(_unsubmitted(), 1, IORING_ENTER_GETEVENTS, NULL, 0) == -1 && errno != EINTR && errno != EBUSY) {
+            break;
+        }
+        
+        unsigned int head = *_cqHead;
+        unsigned int tail = __atomic_load_n(_cqTail, __ATOMIC_ACQUIRE);
+        for (; head != tail; head++) {
+            const struct io_uring_cqe& cqe = _cqes[head & _cqMask];
+            if (cqe.user_data == key) {
+                completed = true;
+            } else {
+                _backlog.push_back(cqe);
+            }
+        }
+        __atomic_store_n(_cqHead, head, __ATOMIC_RELEASE);
+    }
+    
+    _releaseSendBuffer(interest.sending);
+}
+
+bool IoUringPoller::add(int fd, short events) {
+    if (fd < 0) return false;
+    
+    if (static_cast<size_t>(fd) < _interests.size() && _interests[fd].registered) {
+        return modify(fd, events);
+    }
+    
+    _register(fd).events = events;
+    return true;
+}
+
+bool IoUringPoller::addListener(int fd) {
+    if (fd < 0 || (static_cast<size_t>(fd) < _interests.size() && _interests[fd].registered)) return false;
+    
+    Interest& interest = _register(fd);
+    interest.listening = true;
+    interest.events = POLLIN;
+    return true;
+}
+
+bool IoUringPoller::addStream(int fd) {
+    if (fd < 0 || (static_cast<size_t>(fd) < _interests.size() && _interests[fd].registered)) return false;
+    
+    Interest& interest = _register(fd);
+    interest.streaming = true;
+    interest.events = POLLIN;
+    return true;
+}
+
+bool IoUringPoller::modify(int fd, short events) {
+    if (fd < 0 || static_cast<size_t>(fd) >= _interests.size() || !_interests[fd].registered) {
+        return false;
+    }
+    
+    Interest& interest = _interests[fd];
+    if (interest.streaming) {
+        bool reading = interest.events & POLLIN;
+        interest.events = events;
+        if (reading && !(events & POLLIN) && interest.armed) {
+            struct io_uring_sqe* sqe = _nextSqe();
+            if (sqe) {
+                sqe->opcode = IORING_OP_ASYNC_CANCEL;
+                sqe->fd = -1;
+                sqe->addr = _key(OP_RECV, fd, interest.generation);
+                sqe->user_data = _key(OP_CANCEL, fd, 0);
+                _enter(_unsubmitted(), 0, 0, NULL, 0);
+            }
+        }
+        if (reading != ((events & POLLIN) != 0)) {
+            _scheduleArm(fd);
+        }
+        return true;
+    }
+    
+    if (interest.events == events) {
+        return true;
+    }
+    
+    if (interest.armed) {
+        struct io_uring_sqe* sqe = _nextSqe();
+        if (sqe) {
+            sqe->opcode = IORING_OP_POLL_REMOVE;
+            sqe->fd = -1;
+            sqe->addr = _key(OP_POLL, fd, interest.generation);
+            sqe->user_data = _key(OP_CANCEL, fd, 0);
+        }
+        interest.armed = false;
+        interest.generation++;
+    }
+    
+    interest.events = events;
+    _scheduleArm(fd);
+    return true;
+}
+
+void IoUringPoller::remove(int fd) {
+    if (fd < 0 || static_cast<size_t>(fd) >= _interests.size() || !_interests[fd].registered) {
+        return;
+    }
+    
+    Interest& interest = _interests[fd];
+    if (interest.sending != -1) {
+        if (interest.sendArmed) {
+            _awaitSend(fd);
+        } else {
+            _flushDirect(interest.sending);
+            _releaseSendBuffer(interest.sending);
+        }
+        interest.sendArmed = false;
+        interest.sending = -1;
+    }
+    
+    if (interest.armed || interest.watching) {
+        struct io_uring_sqe* sqe = _nextSqe();
+        if (sqe && (interest.streaming || interest.listening)) {
+            sqe->opcode = IORING_OP_ASYNC_CANCEL;
+            sqe->fd = fd;
+            sqe->cancel_flags = IORING_ASYNC_CANCEL_FD | IORING_ASYNC_CANCEL_ALL;
+            sqe->user_data = _key(OP_CANCEL, fd, 0);
+        } else if (sqe) {
+            sqe->opcode = IORING_OP_POLL_REMOVE;
+            sqe->fd = -1;
+            sqe->addr = _key(OP_POLL, fd, interest.generation);
+            sqe->user_data = _key(OP_CANCEL, fd, 0);
+        }
+        _enter(_unsubmitted(), 0, 0, NULL, 0);
+    }
+    
+    interest.registered = false;
+    interest.listening = false;
+    interest.streaming = false;
+    interest.armed = false;
+    interest.watching = false;
+    interest.sendArmed = false;
+    interest.sending = -1;
+    interest.generation++;
+}
+
+size_t IoUringPoller::send(int fd, const struct iovec* iov, size_t count) {
+    if (fd < 0 || static_cast<size_t>(fd) >= _interests.size() || !_interests[fd].streaming) {
+        return 0;
+    }
+    
+    Interest& interest = _interests[fd];
+    if (interest.sending != -1 || count == 0) {
+        return 0;
+    }
+    
+    int index = _takeSendBuffer(fd);
+    _sendBuffers[index]->iov.assign(iov, iov + count);
+    
+    size_t queued = 0;
+    for (size_t i = 0; i < count; i++) {
+        queued += iov[i].iov_len;
+    }
+    
+    interest.sending = index;
+    _scheduleArm(fd);
+    return queued;
+}
+
+void IoUringPoller::_completeSend(const struct io_uring_cqe& cqe, std::vector<PollerEvent>& ready) {
+    size_t index = static_cast<size_t>(cqe.user_data & 0xffffffffULL);
+    if (index >= _sendBuffers.size()) return;
+    
+    int fd = _sendBuffers[index]->fd;
+    if (fd == -1) return;
+    
+    Interest& interest = _interests[fd];
+    interest.sendArmed = false;
+    interest.sending = -1;
+    _releaseSendBuffer(static_cast<int>(index));
+    ready.push_back(makeEvent(POLLER_SENT, fd, 0, cqe.res, NULL));
+}
+
+void IoUringPoller::_complete(const struct io_uring_cqe& cqe, std::vector<PollerEvent>& ready) {
+    Operation op = static_cast<Operation>(cqe.user_data >> 56);
+    if (op == OP_CANCEL) return;
+    
+    if (op == OP_SEND) {
+        _completeSend(cqe, ready);
+        return;
+    }
+    
+    bool buffered = op == OP_RECV && (cqe.flags & IORING_CQE_F_BUFFER);
+    unsigned short bid = buffered ? static_cast<unsigned short>(cqe.flags >> IORING_CQE_BUFFER_SHIFT) : 0;
+    
+    int fd = static_cast<int>(cqe.user_data & 0xffffffffULL);
+    if (fd < 0 || static_cast<size_t>(fd) >= _interests.size() || !_interests[fd].registered
+        || cqe.user_data != _key(op, fd, _interests[fd].generation)) {
+        if (buffered) _recycleBuffer(bid);
+        return;
+    }
+    
+    Interest& interest = _interests[fd];
+    if (op == OP_POLL && interest.streaming) {
+        interest.watching = false;
+        ready.push_back(makeEvent(POLLER_READY, fd, cqe.res < 0 ? POLLERR : static_cast<short>(cqe.res), 0, NULL));
+        return;
+    }
+    
+    if (!(cqe.flags & IORING_CQE_F_MORE)) {
+        interest.armed = false;
+        _scheduleArm(fd);
+    }
+    
+    if (op == OP_ACCEPT) {
+        ready.push_back(makeEvent(POLLER_ACCEPTED, fd, 0, cqe.res, NULL));
+        return;
+    }
+    
+    if (op == OP_POLL) {
+        short events = cqe.res < 0 ? POLLERR : static_cast<short>(cqe.res);
+        if (events != 0) {
+            ready.push_back(makeEvent(POLLER_READY, fd, events, 0, NULL));
+        }
+        return;
+    }
+    
+    if (cqe.res == -ENOBUFS || cqe.res == -ECANCELED) {
+        return;
+    }
+    if (cqe.res == -EINVAL && _multishotRecv) {
+        _multishotRecv = false;
+        return;
+    }
+    
+    const char* data = NULL;
+    if (buffered && cqe.res > 0) {
+        data = _buffers + static_cast<size_t>(bid) * BUFFER_SIZE;
+        _consumed.push_back(bid);
+    } else if (buffered) {
+        _recycleBuffer(bid);
+    }
+    ready.push_back(makeEvent(POLLER_RECEIVED, fd, 0, cqe.res, data));
+}
+
+int IoUringPoller::wait(std::vector<PollerEvent>& ready, int timeoutMs) {
+    ready.clear();
+    
+    for (size_t i = 0; i < _consumed.size(); i++) {
+        _recycleBuffer(_consumed[i]);
+    }
+    _consumed.clear();
+    
+    _arming.swap(_rearm);
+    for (size_t i = 0; i < _arming.size(); i++) {
+        int fd = _arming[i];
+        _interests[fd].queued = false;
+        if (_interests[fd].registered) {
+            _arm(fd);
+        }
+    }
+    _arming.clear();
+    
+    if (!_rearm.empty() && (timeoutMs < 0 || timeoutMs > RETRY_INTERVAL_MS)) {
+        timeoutMs = RETRY_INTERVAL_MS;
+    }
+    
+    for (size_t i = 0; i < _backlog.size(); i++) {
+        _complete(_backlog[i], ready);
+    }
+    _backlog.clear();
+    
+    bool completed = !ready.empty() || *_cqHead != __atomic_load_n(_cqTail, __ATOMIC_ACQUIRE);
+    if (!completed && timeoutMs != 0) {
+        struct __kernel_timespec ts;
+        struct io_uring_getevents_arg arg;
+        memset(&arg, 0, sizeof(arg));
+        if (timeoutMs > 0) {
+            ts.tv_sec = timeoutMs / 1000;
+            ts.tv_nsec = static_cast<long long>(timeoutMs % 1000) * 1000000;
+            arg.ts = reinterpret_cast<unsigned long long>(&ts);
+        }
+        
+        if (_enter(_unsubmitted(), 1, IORING_ENTER_GETEVENTS | IORING_ENTER_EXT_ARG, &arg, sizeof(arg)) == -1
+            && errno != ETIME) {
+            return -1;
+        }
+    } else if (_unsubmitted() > 0) {
+        _enter(_unsubmitted(), 0, 0, NULL, 0);
+    }
+    
+    unsigned int head = *_cqHead;
+    unsigned int tail = __atomic_load_n(_cqTail, __ATOMIC_ACQUIRE);
+    
+    for (; head != tail; head++) {
+        _complete(_cqes[head & _cqMask], ready);
+    }
+    
+    __atomic_store_n(_cqHead, head, __ATOMIC_RELEASE);
+    return static_cast<int>(ready.size());
+}
+
+#endif
@@ -0,0 +1,211 @@
+#ifndef POLLER_HPP
+#define POLLER_HPP
+
+#include <string>
+#include <vector>
+#include <poll.h>
+#include <sys/uio.h>
+#include <sys/socket.h>
+
+#ifdef __linux__
+#include <sys/epoll.h>
+#endif
+
+#if defined(__linux__) && defined(USE_IO_URING)
+#include <linux/io_uring.h>
+#endif
+
+enum PollerEventType {
+    POLLER_READY,
+    POLLER_ACCEPTED,
+    POLLER_RECEIVED,
+    POLLER_SENT
+};
+
+struct PollerEvent {
+    PollerEventType type;
+    int fd;
+    short events;
+    int result;
+    const char* data;
+};
+
+class Poller {
+public:
+    virtual ~Poller() {}
+    
+    virtual const char* getName() const = 0;
+    virtual bool isEdgeTriggered() const { return false; }
+    virtual bool isCompletionBased() const { return false; }
+    
+    virtual bool add(int fd, short events) = 0;
+    virtual bool addListener(int fd) { return add(fd, POLLIN); }
+    virtual bool addStream(int fd) { return add(fd, POLLIN); }
+    virtual bool modify(int fd, short events) = 0;
+    virtual void remove(int fd) = 0;
+    virtual size_t send(int fd, const struct iovec* iov, size_t count) { (void)fd; (void)iov; (void)count; return 0; }
+    virtual int wait(std::vector<PollerEvent>& ready, int timeoutMs) = 0;
+    
+    static Poller* create(const std::string& backend);
+    static bool isValidBackend(const std::string& backend);
+};
+
+class PollPoller : public Poller {
+private:
+    std::vector<struct pollfd> _pollFds;
+    std::vector<int> _slots;
+    
+    PollPoller(const PollPoller&);
+    PollPoller& operator=(const PollPoller&);
+    
+public:
+    PollPoller();
+    virtual ~PollPoller();
+    
+    virtual const char* getName() const { return "poll"; }
+    
+    virtual bool add(int fd, short events);
+    virtual bool modify(int fd, short events);
+    virtual void remove(int fd);
+    virtual int wait(std::vector<PollerEvent>& ready, int timeoutMs);
+};
+
+#ifdef __linux__
+
+class EpollPoller : public Poller {
+private:
+    int _epollFd;
+    bool _edgeTriggered;
+    std::vector<struct epoll_event> _events;
+    
+    unsigned int _toEpoll(short events) const;
+    short _fromEpoll(unsigned int events) const;
+    
+    EpollPoller(const EpollPoller&);
+    EpollPoller& operator=(const EpollPoller&);
+    
+public:
+    EpollPoller(bool edgeTriggered);
+    virtual ~EpollPoller();
+    
+    virtual const char* getName() const { return _edgeTriggered ? "epoll-et" : "epoll"; }
+    virtual bool isEdgeTriggered() const { return _edgeTriggered; }
+    
+    virtual bool add(int fd, short events);
+    virtual bool modify(int fd, short events);
+    virtual void remove(int fd);
+    virtual int wait(std::vector<PollerEvent>& ready, int timeoutMs);
+};
+
+#endif
+
+#if defined(__linux__) && defined(USE_IO_URING)
+
+class IoUringPoller : public Poller {
+private:
+    enum Operation {
+        OP_POLL = 1,
+        OP_ACCEPT,
+        OP_RECV,
+        OP_SEND,
+        OP_CANCEL
+    };
+    
+    struct Interest {
+        short events;
+        unsigned int generation;
+        bool registered;
+        bool listening;
+        bool streaming;
+        bool armed;
+        bool queued;
+        bool watching;
+        bool sendArmed;
+        int sending;
+    };
+    
+    struct SendBuffer {
+        int fd;
+        struct msghdr message;
+        std::vector<struct iovec> iov;
+    };
+    
+    int _ringFd;
+    void* _sqRing;
+    size_t _sqRingSize;
+    void* _cqRing;
+    size_t _cqRingSize;
+    struct io_uring_sqe* _sqes;
+    size_t _sqesSize;
+    
+    unsigned int* _sqHead;
+    unsigned int* _sqTail;
+    unsigned int* _sqArray;
+    unsigned int _sqMask;
+    unsigned int _sqEntries;
+    unsigned int* _cqHead;
+    unsigned int* _cqTail;
+    struct io_uring_cqe* _cqes;
+    unsigned int _cqMask;
+    
+    struct io_uring_buf* _bufRing;
+    unsigned short* _bufRingTail;
+    unsigned short _bufTail;
+    char* _buffers;
+    bool _multishotRecv;
+    std::vector<unsigned short> _consumed;
+    
+    std::vector<Interest> _interests;
+    std::vector<int> _rearm;
+    std::vector<int> _arming;
+    std::vector<SendBuffer*> _sendBuffers;
+    std::vector<int> _freeSendBuffers;
+    std::vector<struct io_uring_cqe> _backlog;
+    
+    static const unsigned int RING_ENTRIES = 1024;
+    static const unsigned int BUFFER_COUNT = 512;
+    static const unsigned int BUFFER_SIZE = 2048;
+    static const unsigned short BUFFER_GROUP = 0;
+    static const int RETRY_INTERVAL_MS = 10;
+    
+    void _setupBuffers();
+    void _release();
+    int _enter(unsigned int toSubmit, unsigned int minComplete, unsigned int flags, void* arg, size_t argSize);
+    unsigned int _unsubmitted() const;
+    struct io_uring_sqe* _nextSqe();
+    unsigned long long _key(Operation op, int fd, unsigned int generation) const;
+    void _recycleBuffer(unsigned short bid);
+    void _arm(int fd);
+    bool _armSend(int fd);
+    bool _armRead(int fd);
+    void _scheduleArm(int fd);
+    Interest& _register(int fd);
+    int _takeSendBuffer(int fd);
+    void _releaseSendBuffer(int index);
+    void _flushDirect(int index);
+    void _awaitSend(int fd);
+    void _complete(const struct io_uring_cqe& cqe, std::vector<PollerEvent>& ready);
+    void _completeSend(const struct io_uring_cqe& cqe, std::vector<PollerEvent>& ready);
+    
+    IoUringPoller(const IoUringPoller&);
+    IoUringPoller& operator=(const IoUringPoller&);
+    
+public:
+    IoUringPoller();
+    virtual ~IoUringPoller();
+    
+    virtual const char* getName() const { return "io_uring"; }
+    virtual bool isCompletionBased() const { return true; }
+    
+    virtual bool add(int fd, short events);
+    virtual bool addListener(int fd);
+    virtual bool addStream(int fd);
+    virtual bool modify(int fd, short events);
+    virtual void remove(int fd);
+    virtual size_t send(int fd, const struct iovec* iov, size_t count);
+    virtual int wait(std::vector<PollerEvent>& ready, int timeoutMs);
+};
+
+#endif
+
+#endif
@@ -0,0 +1,199 @@
+#include "Reactor.hpp"
+#include <stdexcept>
+#include <cstring>
+#include <cerrno>
+#include <csignal>
+#include <unistd.h>
+#include <fcntl.h>
+#include <stdint.h>
+
+#include "Clock.hpp"
+#include "Channel.hpp"
+#include "Client.hpp"
+
+#ifdef __linux__
+#include <sys/eventfd.h>
+#endif
+
+Reactor::Reactor(size_t index, Server* server, const std::string& backend)
+    : _index(index), _server(server), _poller(NULL), _listenFd(-1), _acceptPending(false), _wakePending(0),
+      _threadStarted(false), _inbox(INBOX_CAPACITY), _overflowing(false), _droppedDeliveries(0),
+      _clientPool(Client::getSlotSize(), 64, false), _timers(static_cast<unsigned long long>(monotonicSeconds())) {
+    
+    _openWakeup();
+    
+    _poller = Poller::create(backend);
+    if (!_poller->add(_wakeFds[0], POLLIN)) {
+        std::string error = strerror(errno);
+        delete _poller;
+        close(_wakeFds[0]);
+        if (_wakeFds[1] != _wakeFds[0]) close(_wakeFds[1]);
+        throw std::runtime_error("Failed to register wakeup descriptor: " + error);
+    }
+}
+
+void Reactor::_openWakeup() {
+#ifdef __linux__
+    int fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (fd != -1) {
+        _wakeFds[0] = fd;
+        _wakeFds[1] = fd;
+        return;
+    }
+#endif
+    
+    if (pipe(_wakeFds) == -1) {
+        throw std::runtime_error("Failed to create wakeup pipe: " + std::string(strerror(errno)));
+    }
+    
+    for (int i = 0; i < 2; i++) {
+        fcntl(_wakeFds[i], F_SETFL, O_NONBLOCK);
+        fcntl(_wakeFds[i], F_SETFD, FD_CLOEXEC);
+    }
+}
+
+Reactor::~Reactor() {
+    join();
+    
+    std::vector<Delivery> pending;
+    takeDeliveries(pending);
+    for (size_t i = 0; i < pending.size(); i++) {
+        if (pending[i].payload) pending[i].payload->release();
+        if (pending[i].channel) pending[i].channel->release();
+    }
+    
+    if (_listenFd != -1) {
+        close(_listenFd);
+    }
+    close(_wakeFds[0]);
+    if (_wakeFds[1] != _wakeFds[0]) {
+        close(_wakeFds[1]);
+    }
+    delete _poller;
+}
+
+bool Reactor::addClient(int fd, Client* client) {
+    MutexLock lock(_clientsMutex);
+    return _clients.insert(fd, client);
+}
+
+void Reactor::removeClient(int fd) {
+    MutexLock lock(_clientsMutex);
+    _clients.erase(fd);
+}
+
+void Reactor::clearClients() {
+    MutexLock lock(_clientsMutex);
+    _clients.clear();
+}
+
+void Reactor::post(int fd, unsigned int generation, Payload* payload) {
+    Delivery delivery;
+    delivery.type = DELIVERY_CLIENT;
+    delivery.fd = fd;
+    delivery.generation = generation;
+    delivery.payload = payload;
+    delivery.channel = NULL;
+    delivery.exclude = 0;
+    payload->retain();
+    _push(delivery);
+}
+
+void Reactor::postChannel(Channel* channel, Payload* payload, unsigned long long exclude) {
+    Delivery delivery;
+    delivery.type = DELIVERY_CHANNEL;
+    delivery.fd = -1;
+    delivery.generation = 0;
+    delivery.payload = payload;
+    delivery.channel = channel;
+    delivery.exclude = exclude;
+    payload->retain();
+    channel->retain();
+    _push(delivery);
+}
+
+void Reactor::postPart(int fd, unsigned int generation, Channel* channel) {
+    Delivery delivery;
+    delivery.type = DELIVERY_PART;
+    delivery.fd = fd;
+    delivery.generation = generation;
+    delivery.payload = NULL;
+    delivery.channel = channel;
+    delivery.exclude = 0;
+    channel->retain();
+    _push(delivery);
+}
+
+void Reactor::_push(const Delivery& delivery) {
+    if (delivery.type != DELIVERY_PART) {
+        if (!_inbox.push(delivery)) {
+            if (delivery.payload) delivery.payload->release();
+            if (delivery.channel) delivery.channel->release();
+            __atomic_fetch_add(&_droppedDeliveries, 1ULL, __ATOMIC_RELAXED);
+        }
+    } else if (__atomic_load_n(&_overflowing, __ATOMIC_ACQUIRE) || !_inbox.push(delivery)) {
+        MutexLock lock(_overflowMutex);
+        if (__atomic_load_n(&_overflowing, __ATOMIC_RELAXED) || !_inbox.push(delivery)) {
+            __atomic_store_n(&_overflowing, true, __ATOMIC_RELEASE);
+            _overflow.push_back(delivery);
+        }
+    }
+    
+    if (!__atomic_exchange_n(&_wakePending, 1, __ATOMIC_ACQ_REL)) {
+        wake();
+    }
+}
+
+void Reactor::takeDeliveries(std::vector<Delivery>& deliveries) {
+    deliveries.clear();
+    
+    __atomic_exchange_n(&_wakePending, 0, __ATOMIC_ACQ_REL);
+    
+    Delivery delivery;
+    while (_inbox.pop(delivery)) {
+        deliveries.push_back(delivery);
+    }
+    
+    if (__atomic_load_n(&_overflowing, __ATOMIC_ACQUIRE)) {
+        MutexLock lock(_overflowMutex);
+        while (_inbox.pop(delivery)) {
+            deliveries.push_back(delivery);
+        }
+        deliveries.insert(deliveries.end(), _overflow.begin(), _overflow.end());
+        _overflow.clear();
+        __atomic_store_n(&_overflowing, false, __ATOMIC_RELEASE);
+    }
+}
+
+void Reactor::wake() {
+    uint64_t value = 1;
+    ssize_t result = write(_wakeFds[1], &value, sizeof(value));
+    (void)result;
+}
+
+void Reactor::drainWakeup() {
+    uint64_t buffer[8];
+    while (read(_wakeFds[0], buffer, sizeof(buffer)) > 0) {
+    }
+}
+
+bool Reactor::start(void* (*entry)(void*)) {
+    sigset_t blocked;
+    sigset_t previous;
+    sigemptyset(&blocked);
+    sigaddset(&blocked, SIGINT);
+    sigaddset(&blocked, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &blocked, &previous);
+    
+    _threadStarted = pthread_create(&_thread, NULL, entry, this) == 0;
+    
+    pthread_sigmask(SIG_SETMASK, &previous, NULL);
+    return _threadStarted;
+}
+
+void Reactor::join() {
+    if (_threadStarted) {
+        pthread_join(_thread, NULL);
+        _threadStarted = false;
+    }
+}
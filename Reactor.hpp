@@ -0,0 +1,118 @@
+#ifndef REACTOR_HPP
+#define REACTOR_HPP
+
+#include <string>
+#include <vector>
+#include <set>
+#include <pthread.h>
+
+#include "Poller.hpp"
+#include "Payload.hpp"
+#include "Mutex.hpp"
+#include "MpscQueue.hpp"
+#include "TimerWheel.hpp"
+#include "Histogram.hpp"
+#include "ClientTable.hpp"
+#include "SlabPool.hpp"
+
+class Server;
+class Client;
+class Channel;
+
+enum DeliveryType {
+    DELIVERY_CLIENT,
+    DELIVERY_CHANNEL,
+    DELIVERY_PART
+};
+
+struct Delivery {
+    DeliveryType type;
+    int fd;
+    unsigned int generation;
+    Payload* payload;
+    Channel* channel;
+    unsigned long long exclude;
+};
+
+struct ClientRef {
+    int fd;
+    unsigned int generation;
+};
+
+class Reactor {
+private:
+    size_t _index;
+    Server* _server;
+    Poller* _poller;
+    int _listenFd;
+    bool _acceptPending;
+    int _wakeFds[2];
+    int _wakePending;
+    pthread_t _thread;
+    bool _threadStarted;
+    
+    MpscQueue<Delivery> _inbox;
+    Mutex _overflowMutex;
+    bool _overflowing;
+    std::vector<Delivery> _overflow;
+    unsigned long long _droppedDeliveries;
+    SlabPool _clientPool;
+    ClientTable _clients;
+    Mutex _clientsMutex;
+    std::set<int> _throttledClients;
+    std::vector<ClientRef> _dirtyClients;
+    std::vector<int> _closingClients;
+    TimerWheel _timers;
+    Histogram _loopTimes;
+    std::vector<Histogram> _commandTimes;
+    std::vector<std::string> _params;
+    
+    static const size_t INBOX_CAPACITY = 4096;
+    
+    void _openWakeup();
+    void _push(const Delivery& delivery);
+    
+    Reactor(const Reactor&);
+    Reactor& operator=(const Reactor&);
+    
+public:
+    Reactor(size_t index, Server* server, const std::string& backend);
+    ~Reactor();
+    
+    size_t getIndex() const { return _index; }
+    Server* getServer() const { return _server; }
+    Poller* getPoller() const { return _poller; }
+    int getListenFd() const { return _listenFd; }
+    bool isAcceptPending() const { return _acceptPending; }
+    int getWakeFd() const { return _wakeFds[0]; }
+    SlabPool& getClientPool() { return _clientPool; }
+    const ClientTable& getClients() const { return _clients; }
+    Mutex& getClientsMutex() { return _clientsMutex; }
+    std::set<int>& getThrottledClients() { return _throttledClients; }
+    std::vector<ClientRef>& getDirtyClients() { return _dirtyClients; }
+    std::vector<int>& getClosingClients() { return _closingClients; }
+    TimerWheel& getTimers() { return _timers; }
+    Histogram& getLoopTimes() { return _loopTimes; }
+    std::vector<Histogram>& getCommandTimes() { return _commandTimes; }
+    std::vector<std::string>& getParams() { return _params; }
+    unsigned long long getDroppedDeliveries() const { return __atomic_load_n(&_droppedDeliveries, __ATOMIC_RELAXED); }
+    
+    void setListenFd(int fd) { _listenFd = fd; }
+    void setAcceptPending(bool pending) { _acceptPending = pending; }
+    
+    bool addClient(int fd, Client* client);
+    void removeClient(int fd);
+    void clearClients();
+    
+    void post(int fd, unsigned int generation, Payload* payload);
+    void postChannel(Channel* channel, Payload* payload, unsigned long long exclude);
+    void postPart(int fd, unsigned int generation, Channel* channel);
+    void takeDeliveries(std::vector<Delivery>& deliveries);
+    void wake();
+    void drainWakeup();
+    
+    bool start(void* (*entry)(void*));
+    void join();
+};
+
+#endif
@@ -4,6 +4,8 @@
 #include <new>
 
 Server* Server::instance = NULL;
+const char* const Server::_classNames[CLASS_COUNT] = { "unregistered", "user", "oper" };
+__thread Reactor* Server::_currentReactor = NULL;
 
 std::string intToString(int value) {
     std::ostringstream oss;
@@ -18,8 +20,16 @@ std::string sizeToString(size_t value) {
 }
 
 Server::Server(int port, const std::string& password) 
-    : _port(port), _password(password), _serverSocket(-1), _running(false),
-      _maxClients(100), _totalConnections(0), _currentConnections(0) {
+    : _port(port), _password(password), _running(false), _reactorCount(1),
+      _caseMapping(CASEMAPPING_RFC1459), _maxClients(100),
+      _acceptBatch(64), _listenBacklog(SOMAXCONN),
+      _registrationTimeout(30), _pingInterval(120), _pingTimeout(60),
+      _floodBurst(20), _floodRate(10), _totalConnections(0), _currentConnections(0), _nextClientId(0),
+      _bytesReceived(0), _bytesSent(0), _droppedWrites(0), _metricsPort(0), _metricsFd(-1) {
+    
+    _sendQLimits[CLASS_UNREGISTERED] = 32768;
+    _sendQLimits[CLASS_USER] = 1048576;
+    _sendQLimits[CLASS_OPERATOR] = 4194304;
     
     _serverName = "msn.chat.1337";
     _serverVersion = "msn-1.0.1337";
@@ -28,6 +38,12 @@ Server::Server(int port, const std::string& password)
             "For help, contact your system administrator.\n"
             "O chati m3a rassk!";
     
+#ifdef __linux__
+    _pollBackend = "epoll";
+#else
+    _pollBackend = "poll";
+#endif
+    
     time(&_startTime);
     time_t rawtime;
     time(&rawtime);
@@ -41,18 +57,21 @@ Server::Server(int port, const std::string& password)
     signal(SIGTERM, signalHandler);
     signal(SIGPIPE, SIG_IGN);
     
-    _logMessage("INFO", "IRC Server initialized");
+    _logMessage(LOG_INFO, "IRC Server initialized");
 }
 
 Server::~Server() {
     shutdown();
+    _logger.stop();
 }
 
 void Server::signalHandler(int signum) {
     (void)signum;
     if (instance) {
-        std::cout << "\n" << YELLOW << "Signal received. Initiating graceful shutdown..." << RESET << std::endl;
-        instance->shutdown();
+        int savedErrno = errno;
+        instance->_running = false;
+        instance->_wakeReactors();
+        errno = savedErrno;
     }
 }
 
@@ -68,233 +87,662 @@ void Server::start() {
         std::cout << "║ " << CYAN << "Version:     " << RESET << std::setw(19) << std::left << _serverVersion << GREEN << " ║" << std::endl;
         std::cout << "║ " << CYAN << "Port:        " << RESET << std::setw(19) << std::left << _port << GREEN << " ║" << std::endl;
         std::cout << "║ " << CYAN << "Max Clients: " << RESET << std::setw(19) << std::left << _maxClients << GREEN << " ║" << std::endl;
+        std::cout << "║ " << CYAN << "I/O Backend: " << RESET << std::setw(19) << std::left << _reactors[0]->getPoller()->getName() << GREEN << " ║" << std::endl;
+        std::cout << "║ " << CYAN << "Reactors:    " << RESET << std::setw(19) << std::left << _reactors.size() << GREEN << " ║" << std::endl;
         std::cout << "║ " << CYAN << "Started:     " << RESET << std::setw(19) << std::left << _formatTime(_startTime) << GREEN << " ║" << std::endl;
         std::cout << "╚══════════════════════════════════╝" << RESET << std::endl;
         
-        _logMessage("INFO", "Server listening on port " + intToString(_port));
+        _logger.start();
+        _logMessage(LOG_INFO, "Server listening on port " + intToString(_port));
+        if (_metricsFd != -1) {
+            _logMessage(LOG_INFO, "Metrics available at http://127.0.0.1:" + intToString(_metricsPort) + "/metrics");
+        }
+        
+        for (size_t i = 1; i < _reactors.size(); i++) {
+            if (!_reactors[i]->start(_reactorMain)) {
+                _running = false;
+                _wakeReactors();
+                throw std::runtime_error("Failed to start reactor thread: " + std::string(strerror(errno)));
+            }
+        }
+        
+        _runReactor(_reactors[0]);
         
-        while (_running) {
-            int pollResult = poll(_pollFds.data(), _pollFds.size(), 1000);
+        _running = false;
+        _wakeReactors();
+        for (size_t i = 1; i < _reactors.size(); i++) {
+            _reactors[i]->join();
+        }
+    } catch (const std::exception& e) {
+        _logMessage(LOG_FATAL, "Server error: " + std::string(e.what()));
+        _logger.stop();
+        throw;
+    }
+}
+
+void* Server::_reactorMain(void* arg) {
+    Reactor* reactor = static_cast<Reactor*>(arg);
+    Server* server = reactor->getServer();
+    
+    try {
+        server->_runReactor(reactor);
+    } catch (const std::exception& e) {
+        server->_logMessage(LOG_FATAL, "Reactor " + sizeToString(reactor->getIndex()) + " error: " + std::string(e.what()));
+        server->_running = false;
+        server->_wakeReactors();
+    }
+    return NULL;
+}
+
+void Server::_runReactor(Reactor* reactor) {
+    _currentReactor = reactor;
+    
+    Poller* poller = reactor->getPoller();
+    std::vector<PollerEvent> events;
+    std::vector<int> acceptedFds;
+    std::vector<Delivery> deliveries;
+    std::vector<TimerNode*> expired;
+    
+    while (_running) {
+        int pollResult = poller->wait(events, _getLoopTimeout(reactor));
+        
+        if (pollResult == -1) {
+            if (errno == EINTR) {
+                continue;
+            }
+            _logMessage(LOG_ERROR, std::string(poller->getName()) + " wait failed: " + std::string(strerror(errno)));
+            _running = false;
+            _wakeReactors();
+            break;
+        }
+        
+        unsigned long long iterationStart = monotonicNanoseconds();
+        
+        bool acceptPending = false;
+        
+        for (size_t i = 0; i < events.size() && _running; i++) {
+            int fd = events[i].fd;
+            short revents = events[i].events;
+            
+            if (events[i].type == POLLER_ACCEPTED) {
+                acceptedFds.push_back(events[i].result);
+                continue;
+            }
+            
+            if (events[i].type == POLLER_RECEIVED) {
+                _handleClientReceive(fd, events[i].data, events[i].result);
+                continue;
+            }
+            
+            if (events[i].type == POLLER_SENT) {
+                _handleClientSent(fd, events[i].result);
+                continue;
+            }
+            
+            if (fd == reactor->getListenFd()) {
+                acceptPending = true;
+                continue;
+            }
             
-            if (pollResult == -1) {
-                if (errno == EINTR) {
-                    continue;
-                }
-                _logMessage("ERROR", "poll() failed: " + std::string(strerror(errno)));
-                break;
+            if (fd == reactor->getWakeFd()) {
+                reactor->drainWakeup();
+                continue;
             }
             
-            if (pollResult == 0) {
-                _cleanupEmptyChannels();
+            if (fd == _metricsFd) {
+                _acceptMetricsClients();
                 continue;
             }
             
-            for (size_t i = 0; i < _pollFds.size() && _running; ) {
-                if (_pollFds[i].revents == 0) {
-                    i++;
-                    continue;
-                }
-                
-                bool clientRemoved = false;
-                
-                if (_pollFds[i].revents & POLLIN) {
-                    if (_pollFds[i].fd == _serverSocket) {
-                        _acceptNewClient();
-                    } else {
-                        _handleClientData(_pollFds[i].fd);
-                    }
-                }
-                
-                if (_pollFds[i].revents & (POLLHUP | POLLERR | POLLNVAL)) {
-                    _logMessage("WARNING", "Client connection error on fd " + intToString(_pollFds[i].fd));
-                    _disconnectClient(_pollFds[i].fd, "Connection error");
-                    clientRemoved = true;
-                }
-                
-                if (!clientRemoved) {
-                    i++;
-                }
+            if (_isMetricsConnection(reactor, fd)) {
+                _handleMetricsEvent(fd, revents);
+                continue;
+            }
+            
+            if (revents & POLLIN) {
+                _handleClientData(fd);
+            }
+            
+            if (revents & POLLOUT) {
+                _handleClientWrite(fd);
+            }
+            
+            if ((revents & (POLLHUP | POLLERR | POLLNVAL)) && _findOwnedClient(fd)) {
+                _logMessage(LOG_WARNING, "Client connection error on fd " + intToString(fd));
+                _disconnectClient(fd, "Connection error");
             }
         }
-    } catch (const std::exception& e) {
-        _logMessage("FATAL", "Server error: " + std::string(e.what()));
-        throw;
+        
+        _processDeliveries(reactor, deliveries);
+        
+        for (size_t i = 0; i < acceptedFds.size(); i++) {
+            _acceptCompleted(reactor, acceptedFds[i]);
+        }
+        acceptedFds.clear();
+        
+        if ((acceptPending || reactor->isAcceptPending()) && _running) {
+            size_t accepted = 0;
+            while (accepted < _acceptBatch && _acceptNewClient(reactor)) {
+                accepted++;
+            }
+            reactor->setAcceptPending(accepted == _acceptBatch);
+        }
+        
+        _processThrottledClients(reactor);
+        _processTimers(reactor, expired);
+        _closeSendQExceeded(reactor);
+        _flushDirtyClients(reactor);
+        _expireMetricsConnections(reactor);
+        
+        reactor->getLoopTimes().record(monotonicNanoseconds() - iterationStart);
     }
 }
 
+void Server::_wakeReactors() {
+    for (size_t i = 0; i < _reactors.size(); i++) {
+        _reactors[i]->wake();
+    }
+}
+
+Reactor* Server::_getReactor(Client* client) const {
+    return _reactors[client->getReactor()];
+}
+
+Client* Server::_findOwnedClient(int clientFd) {
+    if (!_currentReactor) return NULL;
+    return _currentReactor->getClients().find(clientFd);
+}
+
 void Server::stop() {
     _running = false;
-    _logMessage("INFO", "Server stop requested");
+    _wakeReactors();
+    _logMessage(LOG_INFO, "Server stop requested");
 }
 
 void Server::shutdown() {
-    if (!_running && _serverSocket == -1) return;
+    if (!_running && _reactors.empty()) return;
     
     _running = false;
+    _wakeReactors();
+    for (size_t i = 0; i < _reactors.size(); i++) {
+        _reactors[i]->join();
+    }
+    _currentReactor = NULL;
     
-    std::cout << YELLOW << "Shutting down server gracefully..." << RESET << std::endl;
+    _logMessage(LOG_INFO, "Shutting down server gracefully...");
     
-    std::map<int, Client*> clientsCopy = _clients;
-    for (std::map<int, Client*>::iterator it = clientsCopy.begin(); it != clientsCopy.end(); ++it) {
-        _sendToClient(it->first, "ERROR :Server shutting down");
-        delete it->second;
+    while (!_metricsConnections.empty()) {
+        _closeMetricsConnection(_metricsConnections.begin()->first);
+    }
+    if (_metricsFd != -1) {
+        close(_metricsFd);
+        _metricsFd = -1;
     }
-    _clients.clear();
     
-    std::map<std::string, Channel*> channelsCopy = _channels;
-    for (std::map<std::string, Channel*>::iterator it = channelsCopy.begin(); it != channelsCopy.end(); ++it) {
-        delete it->second;
+    for (size_t i = 0; i < _reactors.size(); i++) {
+        const ClientTable& clients = _reactors[i]->getClients();
+        std::vector<Client*> clientsCopy(clients.begin(), clients.end());
+        for (size_t j = 0; j < clientsCopy.size(); j++) {
+            _sendToClient(clientsCopy[j], "ERROR :Server shutting down");
+            _reactors[i]->getPoller()->remove(clientsCopy[j]->getFd());
+            delete clientsCopy[j];
+        }
+        _reactors[i]->clearClients();
     }
-    _channels.clear();
+    _nicknames.clear();
     
-    if (_serverSocket != -1) {
-        close(_serverSocket);
-        _serverSocket = -1;
+    std::vector<Channel*> channels = getChannelList();
+    for (size_t i = 0; i < channels.size(); i++) {
+        channels[i]->release();
     }
+    _channels.clear();
     
-    _pollFds.clear();
+    for (size_t i = 0; i < _reactors.size(); i++) {
+        delete _reactors[i];
+    }
+    _reactors.clear();
     
-    std::cout << GREEN << "Server shutdown complete. Goodbye!" << RESET << std::endl;
-    _logMessage("INFO", "Server shutdown completed successfully");
+    _logMessage(LOG_INFO, "Server shutdown completed successfully");
 }
 
 void Server::_setupSocket() {
-    _serverSocket = socket(AF_INET, SOCK_STREAM, 0);
-    if (_serverSocket == -1) {
+#ifndef SO_REUSEPORT
+    if (_reactorCount > 1) {
+        _logMessage(LOG_WARNING, "SO_REUSEPORT unavailable, running a single reactor");
+        _reactorCount = 1;
+    }
+#endif
+    
+    for (size_t i = 0; i < _reactorCount; i++) {
+        Reactor* reactor = new Reactor(i, this, _pollBackend);
+        _reactors.push_back(reactor);
+        reactor->getCommandTimes().resize(_commandCount);
+        
+        reactor->setListenFd(_createListenSocket(_port, INADDR_ANY, _reactorCount > 1));
+        if (!reactor->getPoller()->addListener(reactor->getListenFd())) {
+            throw std::runtime_error("Failed to register listening socket: " + std::string(strerror(errno)));
+        }
+    }
+    
+    if (_metricsPort > 0) {
+        _setupMetricsSocket();
+    }
+    
+    if (_reactors[0]->getPoller()->getName() != _pollBackend) {
+        _logMessage(LOG_WARNING, _pollBackend + " backend unavailable, falling back to " + _reactors[0]->getPoller()->getName());
+    }
+}
+
+int Server::_createListenSocket(int port, in_addr_t address, bool reusePort) {
+    int listenFd = socket(AF_INET, SOCK_STREAM, 0);
+    if (listenFd == -1) {
         throw std::runtime_error("Failed to create socket: " + std::string(strerror(errno)));
     }
     
     int opt = 1;
-    if (setsockopt(_serverSocket, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt)) == -1) {
-        close(_serverSocket);
+    if (setsockopt(listenFd, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt)) == -1) {
+        close(listenFd);
         throw std::runtime_error("Failed to set SO_REUSEADDR: " + std::string(strerror(errno)));
     }
     
-    if (fcntl(_serverSocket, F_SETFL, O_NONBLOCK) == -1) {
-        close(_serverSocket);
+#ifdef SO_REUSEPORT
+    if (reusePort && setsockopt(listenFd, SOL_SOCKET, SO_REUSEPORT, &opt, sizeof(opt)) == -1) {
+        close(listenFd);
+        throw std::runtime_error("Failed to set SO_REUSEPORT: " + std::string(strerror(errno)));
+    }
+#else
+    (void)reusePort;
+#endif
+    
+    if (setsockopt(listenFd, SOL_SOCKET, SO_KEEPALIVE, &opt, sizeof(opt)) == -1) {
+        _logMessage(LOG_WARNING, "Failed to set keepalive on listening socket");
+    }
+    
+    if (setsockopt(listenFd, IPPROTO_TCP, TCP_NODELAY, &opt, sizeof(opt)) == -1) {
+        _logMessage(LOG_WARNING, "Failed to set TCP_NODELAY on listening socket");
+    }
+    
+    if (fcntl(listenFd, F_SETFL, O_NONBLOCK) == -1) {
+        close(listenFd);
         throw std::runtime_error("Failed to set non-blocking: " + std::string(strerror(errno)));
     }
     
     struct sockaddr_in serverAddr;
     memset(&serverAddr, 0, sizeof(serverAddr));
     serverAddr.sin_family = AF_INET;
-    serverAddr.sin_addr.s_addr = INADDR_ANY;
-    serverAddr.sin_port = htons(_port);
+    serverAddr.sin_addr.s_addr = htonl(address);
+    serverAddr.sin_port = htons(port);
     
-    if (bind(_serverSocket, (struct sockaddr*)&serverAddr, sizeof(serverAddr)) == -1) {
-        close(_serverSocket);
-        throw std::runtime_error("Failed to bind to port " + intToString(_port) + ": " + std::string(strerror(errno)));
+    if (bind(listenFd, (struct sockaddr*)&serverAddr, sizeof(serverAddr)) == -1) {
+        close(listenFd);
+        throw std::runtime_error("Failed to bind to port " + intToString(port) + ": " + std::string(strerror(errno)));
     }
     
-    if (listen(_serverSocket, 128) == -1) {
-        close(_serverSocket);
+    if (listen(listenFd, _listenBacklog) == -1) {
+        close(listenFd);
         throw std::runtime_error("Failed to listen on socket: " + std::string(strerror(errno)));
     }
     
-    struct pollfd serverPollFd;
-    serverPollFd.fd = _serverSocket;
-    serverPollFd.events = POLLIN;
-    serverPollFd.revents = 0;
-    _pollFds.push_back(serverPollFd);
+    return listenFd;
 }
 
-void Server::_acceptNewClient() {
+bool Server::_acceptNewClient(Reactor* reactor) {
     struct sockaddr_in clientAddr;
     socklen_t clientLen = sizeof(clientAddr);
     
-    int clientFd = accept(_serverSocket, (struct sockaddr*)&clientAddr, &clientLen);
+#ifdef __linux__
+    int clientFd = accept4(reactor->getListenFd(), (struct sockaddr*)&clientAddr, &clientLen, SOCK_NONBLOCK | SOCK_CLOEXEC);
+#else
+    int clientFd = accept(reactor->getListenFd(), (struct sockaddr*)&clientAddr, &clientLen);
+#endif
     if (clientFd == -1) {
         if (errno != EWOULDBLOCK && errno != EAGAIN) {
-            _logMessage("WARNING", "Failed to accept connection: " + std::string(strerror(errno)));
+            _logMessage(LOG_WARNING, "Failed to accept connection: " + std::string(strerror(errno)));
         }
+        return false;
+    }
+    
+    _registerClient(reactor, clientFd, clientAddr);
+    return true;
+}
+
+void Server::_acceptCompleted(Reactor* reactor, int result) {
+    if (result < 0) {
+        _logMessage(LOG_WARNING, "Failed to accept connection: " + std::string(strerror(-result)));
         return;
     }
     
-    if (_currentConnections >= _maxClients) {
+    struct sockaddr_in clientAddr;
+    socklen_t clientLen = sizeof(clientAddr);
+    if (getpeername(result, (struct sockaddr*)&clientAddr, &clientLen) == -1) {
+        _logMessage(LOG_WARNING, "Failed to read peer address: " + std::string(strerror(errno)));
+        close(result);
+        return;
+    }
+    
+    _registerClient(reactor, result, clientAddr);
+}
+
+void Server::_registerClient(Reactor* reactor, int clientFd, const struct sockaddr_in& clientAddr) {
+    if (__atomic_add_fetch(&_currentConnections, 1, __ATOMIC_RELAXED) > _maxClients) {
+        __atomic_sub_fetch(&_currentConnections, 1, __ATOMIC_RELAXED);
         std::string errorMsg = "ERROR :Server is full (max " + sizeToString(_maxClients) + " clients)";
         send(clientFd, errorMsg.c_str(), errorMsg.length(), 0);
         close(clientFd);
-        _logMessage("INFO", "Connection rejected - server full");
+        _logMessage(LOG_INFO, "Connection rejected - server full");
         return;
     }
     
+#ifndef __linux__
     if (fcntl(clientFd, F_SETFL, O_NONBLOCK) == -1) {
-        _logMessage("ERROR", "Failed to set client socket non-blocking: " + std::string(strerror(errno)));
+        _logMessage(LOG_ERROR, "Failed to set client socket non-blocking: " + std::string(strerror(errno)));
+        __atomic_sub_fetch(&_currentConnections, 1, __ATOMIC_RELAXED);
         close(clientFd);
         return;
     }
     
     int keepAlive = 1;
     if (setsockopt(clientFd, SOL_SOCKET, SO_KEEPALIVE, &keepAlive, sizeof(keepAlive)) == -1) {
-        _logMessage("WARNING", "Failed to set keepalive on client socket");
+        _logMessage(LOG_WARNING, "Failed to set keepalive on client socket");
+    }
+    
+    int noDelay = 1;
+    if (setsockopt(clientFd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay)) == -1) {
+        _logMessage(LOG_WARNING, "Failed to set TCP_NODELAY on client socket");
     }
+#endif
     
     Client* client = NULL;
     try {
-        client = new Client(clientFd, this);
+        client = new (reactor->getClientPool()) Client(clientFd, this);
     } catch (const std::bad_alloc& e) {
+        __atomic_sub_fetch(&_currentConnections, 1, __ATOMIC_RELAXED);
         close(clientFd);
-        _logMessage("ERROR", "Memory allocation failed for new client");
+        _logMessage(LOG_ERROR, "Memory allocation failed for new client");
         return;
     }
     
     std::string hostname = inet_ntoa(clientAddr.sin_addr);
     client->setHostname(hostname);
+    client->setId(__atomic_add_fetch(&_nextClientId, 1, __ATOMIC_RELAXED));
+    client->setReactor(reactor->getIndex());
+    client->setLastInput(monotonicSeconds());
+    client->refillFloodTokens(client->getLastInput(), _floodRate, _floodBurst);
+    
+    if (!reactor->getPoller()->addStream(clientFd)) {
+        _logMessage(LOG_ERROR, "Failed to register client socket: " + std::string(strerror(errno)));
+        __atomic_sub_fetch(&_currentConnections, 1, __ATOMIC_RELAXED);
+        close(clientFd);
+        delete client;
+        return;
+    }
     
-    _clients[clientFd] = client;
-    _totalConnections++;
-    _currentConnections++;
-    
-    struct pollfd clientPollFd;
-    clientPollFd.fd = clientFd;
-    clientPollFd.events = POLLIN;
-    clientPollFd.revents = 0;
-    _pollFds.push_back(clientPollFd);
-    
-    std::cout << GREEN << "[" << _formatTime(time(NULL)) << "] " 
-              << CYAN << "New connection from " << hostname 
-              << " (fd: " << clientFd << ") - Total: " << _currentConnections 
-              << "/" << _maxClients << RESET << std::endl;
+    if (!reactor->addClient(clientFd, client)) {
+        _logMessage(LOG_ERROR, "Client table rejected fd " + intToString(clientFd));
+        __atomic_sub_fetch(&_currentConnections, 1, __ATOMIC_RELAXED);
+        reactor->getPoller()->remove(clientFd);
+        close(clientFd);
+        delete client;
+        return;
+    }
+    __atomic_add_fetch(&_totalConnections, 1, __ATOMIC_RELAXED);
+    client->setGeneration(reactor->getClients().getGeneration(clientFd));
+    _scheduleClientTimer(client, _registrationTimeout);
     
-    _logMessage("INFO", "Client connected from " + hostname + " (fd: " + intToString(clientFd) + ")");
+    _logMessage(LOG_INFO, "Client connected from " + hostname + " (fd: " + intToString(clientFd) + ") - Total: "
+                + sizeToString(getCurrentConnections()) + "/" + sizeToString(_maxClients));
 }
 
 void Server::_handleClientData(int clientFd) {
-    std::map<int, Client*>::iterator it = _clients.find(clientFd);
-    if (it == _clients.end()) return;
-    
-    Client* client = it->second;
-    char buffer[4096];
-    
-    ssize_t bytesRead = recv(clientFd, buffer, sizeof(buffer) - 1, 0);
+    do {
+        Client* client = _findOwnedClient(clientFd);
+        if (!client) return;
+        
+        InputBuffer& input = client->getInputBuffer();
+        
+        if (client->isThrottled()) return;
+        
+        size_t writable = input.getWritableSize();
+        ssize_t bytesRead = recv(clientFd, input.getWritePtr(), writable, 0);
+        
+        if (bytesRead <= 0) {
+            if (bytesRead == 0) {
+                _disconnectClient(clientFd, "Client disconnected");
+            } else if (errno != EWOULDBLOCK && errno != EAGAIN) {
+                _disconnectClient(clientFd, "Read error: " + std::string(strerror(errno)));
+            }
+            return;
+        }
+        
+        input.commit(static_cast<size_t>(bytesRead));
+        client->setLastInput(monotonicSeconds());
+        client->updateActivity();
+        client->addBytesReceived(static_cast<size_t>(bytesRead));
+        __atomic_fetch_add(&_bytesReceived, static_cast<unsigned long long>(bytesRead), __ATOMIC_RELAXED);
+        
+        if (!_processClientInput(client)) return;
+    } while (_currentReactor->getPoller()->isEdgeTriggered());
+}
+
+void Server::_handleClientReceive(int clientFd, const char* data, int result) {
+    Client* client = _findOwnedClient(clientFd);
+    if (!client) return;
     
-    if (bytesRead <= 0) {
-        if (bytesRead == 0) {
+    if (result <= 0) {
+        if (result == 0) {
             _disconnectClient(clientFd, "Client disconnected");
-        } else if (errno != EWOULDBLOCK && errno != EAGAIN) {
-            _disconnectClient(clientFd, "Read error: " + std::string(strerror(errno)));
+        } else {
+            _disconnectClient(clientFd, "Read error: " + std::string(strerror(-result)));
         }
         return;
     }
     
-    buffer[bytesRead] = '\0';
-    std::string receivedData(buffer);
-    
-    _validateClientInput(client, receivedData);
+    client->receiveInput(data, static_cast<size_t>(result));
+    client->setLastInput(monotonicSeconds());
+    client->updateActivity();
+    client->addBytesReceived(static_cast<size_t>(result));
+    __atomic_fetch_add(&_bytesReceived, static_cast<unsigned long long>(result), __ATOMIC_RELAXED);
     
-    if (_isClientFlooding(client)) {
+    if (client->isInputOverflowing()) {
         _disconnectClient(clientFd, "Excess flood");
         return;
     }
     
-    client->appendToBuffer(receivedData);
+    _processClientInput(client);
+}
+
+bool Server::_processClientInput(Client* client) {
+    int clientFd = client->getFd();
+    unsigned int generation = client->getGeneration();
+    Reactor* reactor = _getReactor(client);
+    const char* line;
+    size_t length;
+    
+    while (_rateLimitCheck(client) && client->nextInputLine(line, length)) {
+        client->incrementMessageCount();
+        _validateClientInput(client, line, length);
+        _processMessage(client, line, length);
+        if (!reactor->getClients().find(clientFd, generation)) return false;
+    }
     
-    std::vector<std::string> messages = client->extractMessages();
-    for (size_t i = 0; i < messages.size(); i++) {
-        if (!messages[i].empty()) {
-            _processMessage(client, messages[i]);
+    bool throttled = !_rateLimitCheck(client);
+    if (throttled != client->isThrottled()) {
+        std::set<int>& throttledClients = reactor->getThrottledClients();
+        client->setThrottled(throttled);
+        if (throttled) {
+            throttledClients.insert(clientFd);
+        } else {
+            throttledClients.erase(clientFd);
         }
     }
+    _updatePollInterest(client);
+    return true;
+}
+
+void Server::_processDeliveries(Reactor* reactor, std::vector<Delivery>& deliveries) {
+    reactor->takeDeliveries(deliveries);
+    if (deliveries.empty()) return;
+    
+    const ClientTable& clients = reactor->getClients();
+    for (size_t i = 0; i < deliveries.size(); i++) {
+        Delivery& delivery = deliveries[i];
+        if (delivery.type == DELIVERY_CHANNEL) {
+            delivery.channel->lock();
+            ChannelLock channelLock(delivery.channel);
+            _sendToLocalMembers(delivery.channel, reactor->getIndex(), delivery.payload, delivery.exclude);
+            delivery.payload->release();
+            continue;
+        }
+        
+        Client* client = clients.find(delivery.fd, delivery.generation);
+        if (delivery.type == DELIVERY_PART) {
+            delivery.channel->lock();
+            ChannelLock channelLock(delivery.channel);
+            if (client && !delivery.channel->hasClient(client)) {
+                client->forgetChannel(delivery.channel);
+            }
+            continue;
+        }
+        
+        if (client) {
+            _sendPayload(client, delivery.payload);
+        }
+        delivery.payload->release();
+    }
+    deliveries.clear();
+}
+
+void Server::_processThrottledClients(Reactor* reactor) {
+    std::set<int>& throttledClients = reactor->getThrottledClients();
+    if (throttledClients.empty()) return;
+    
+    const ClientTable& clients = reactor->getClients();
+    std::vector<int> throttled(throttledClients.begin(), throttledClients.end());
+    for (size_t i = 0; i < throttled.size(); i++) {
+        Client* client = clients.find(throttled[i]);
+        if (!client) {
+            throttledClients.erase(throttled[i]);
+            continue;
+        }
+        
+        if (_rateLimitCheck(client)) {
+            _processClientInput(client);
+        }
+    }
+}
+
+void Server::_processTimers(Reactor* reactor, std::vector<TimerNode*>& expired) {
+    double now = monotonicSeconds();
+    reactor->getTimers().advance(static_cast<unsigned long long>(now), expired);
+    if (expired.empty()) return;
+    
+    for (size_t i = 0; i < expired.size(); i++) {
+        _handleClientTimer(static_cast<Client*>(expired[i]->owner), now);
+    }
+}
+
+void Server::_scheduleClientTimer(Client* client, double delay) {
+    double expires = monotonicSeconds() + delay;
+    unsigned long long tick = static_cast<unsigned long long>(expires);
+    if (tick < expires) {
+        tick++;
+    }
+    _getReactor(client)->getTimers().schedule(client->getTimer(), tick);
+}
+
+void Server::_handleClientTimer(Client* client, double now) {
+    double idle = now - client->getLastInput();
+    
+    switch (client->getTimerState()) {
+        case TIMER_REGISTRATION:
+            if (!client->isRegistered()) {
+                _disconnectClient(client->getFd(), "Registration timeout");
+                return;
+            }
+            client->setTimerState(TIMER_PING);
+            _handleClientTimer(client, now);
+            return;
+        
+        case TIMER_PING:
+            if (idle < _pingInterval) {
+                _scheduleClientTimer(client, _pingInterval - idle);
+                return;
+            }
+            _sendToClient(client->getFd(), "PING :" + _serverName);
+            client->setPingSentAt(now);
+            client->setTimerState(TIMER_AWAIT_PONG);
+            _scheduleClientTimer(client, _pingTimeout);
+            return;
+        
+        case TIMER_AWAIT_PONG:
+            if (client->getLastInput() >= client->getPingSentAt()) {
+                client->setTimerState(TIMER_PING);
+                _scheduleClientTimer(client, _pingInterval - idle);
+                return;
+            }
+            _disconnectClient(client->getFd(), "Ping timeout: " + sizeToString(static_cast<size_t>(idle)) + " seconds");
+            return;
+    }
+}
+
+int Server::_getLoopTimeout(Reactor* reactor) {
+    if (reactor->isAcceptPending()) {
+        return 0;
+    }
+    
+    int timeout = 1000;
+    if (!reactor->getTimers().empty()) {
+        double now = monotonicSeconds();
+        timeout = static_cast<int>((static_cast<unsigned long long>(now) + 1 - now) * 1000) + 1;
+    }
+    
+    std::set<int>& throttledClients = reactor->getThrottledClients();
+    if (throttledClients.empty() || _floodRate <= 0) {
+        return timeout;
+    }
+    
+    const ClientTable& clients = reactor->getClients();
+    double deficit = 0;
+    for (std::set<int>::const_iterator it = throttledClients.begin(); it != throttledClients.end(); ++it) {
+        Client* client = clients.find(*it);
+        if (!client) {
+            return 0;
+        }
+        double tokens = client->getFloodTokens();
+        if (it == throttledClients.begin() || -tokens < deficit) {
+            deficit = -tokens;
+        }
+    }
+    
+    int throttleTimeout = static_cast<int>(deficit / _floodRate * 1000) + 1;
+    return throttleTimeout < timeout ? throttleTimeout : timeout;
+}
+
+void Server::_handleClientWrite(int clientFd) {
+    Client* client = _findOwnedClient(clientFd);
+    if (!client) return;
+    
+    _flushClient(client);
+}
+
+void Server::_handleClientSent(int clientFd, int result) {
+    Client* client = _findOwnedClient(clientFd);
+    if (!client) return;
+    
+    client->setOutputInFlight(0);
+    if (result < 0) {
+        if (result != -EPIPE) {
+            _logMessage(LOG_WARNING, "Send failed to fd " + intToString(clientFd) + ": " + strerror(-result));
+        }
+        __atomic_fetch_add(&_droppedWrites, 1ULL, __ATOMIC_RELAXED);
+        client->clearOutput();
+        _disconnectClient(clientFd, "Write error: " + std::string(strerror(-result)));
+        return;
+    }
+    
+    client->consumeOutput(static_cast<size_t>(result));
+    __atomic_fetch_add(&_bytesSent, static_cast<unsigned long long>(result), __ATOMIC_RELAXED);
+    _flushClient(client);
 }
 
 void Server::_removeClient(int clientFd) {
@@ -302,87 +750,204 @@ void Server::_removeClient(int clientFd) {
 }
 
 void Server::_disconnectClient(int clientFd, const std::string& reason) {
-    std::map<int, Client*>::iterator it = _clients.find(clientFd);
-    if (it == _clients.end()) return;
+    Client* client = _findOwnedClient(clientFd);
+    if (!client) return;
     
-    Client* client = it->second;
     std::string nickname = client->getNickname().empty() ? "*" : client->getNickname();
+    std::string quitMsg = ":" + client->getPrefix() + " QUIT :" + reason;
     
-    std::set<Channel*> channels = client->getChannels();
-    for (std::set<Channel*>::iterator chIt = channels.begin(); chIt != channels.end(); ++chIt) {
-        Channel* channel = *chIt;
-        if (!channel->isEmpty()) {
-            std::string quitMsg = ":" + client->getPrefix() + " QUIT :" + reason;
+    std::vector<Channel*> channels;
+    client->collectChannels(channels);
+    for (size_t i = 0; i < channels.size(); i++) {
+        Channel* channel = channels[i];
+        channel->lock();
+        ChannelLock channelLock(channel);
+        if (channel->hasClient(client)) {
             _sendToChannel(channel, quitMsg, client);
+            _partChannel(client, channel);
         }
-        channel->removeClient(client);
-        channel->removeOperator(client);
     }
     
-    for (std::vector<struct pollfd>::iterator pIt = _pollFds.begin(); pIt != _pollFds.end(); ++pIt) {
-        if (pIt->fd == clientFd) {
-            _pollFds.erase(pIt);
-            break;
-        }
+    if (client->hasPendingOutput()) {
+        _flushClient(client);
+    }
+    
+    if (!client->getNickname().empty()) {
+        WriteLock lock(_nicknamesLock);
+        _nicknames.erase(client->getFoldedNickname());
     }
     
+    Reactor* reactor = _getReactor(client);
+    reactor->getTimers().cancel(client->getTimer());
+    reactor->getThrottledClients().erase(clientFd);
+    reactor->getPoller()->remove(clientFd);
     close(clientFd);
+    reactor->removeClient(clientFd);
     delete client;
-    _clients.erase(it);
-    _currentConnections--;
+    size_t connections = __atomic_sub_fetch(&_currentConnections, 1, __ATOMIC_RELAXED);
+    
+    _logMessage(LOG_INFO, "Client " + nickname + " disconnected: " + reason + " (fd: " + intToString(clientFd) + ") - Total: "
+                + sizeToString(connections) + "/" + sizeToString(_maxClients));
+}
+void Server::_processMessage(Client* client, const char* line, size_t length) {
+    if (length == 0 || length > 512) {
+        client->chargeFloodTokens(1);
+        return;
+    }
     
-    std::cout << RED << "[" << _formatTime(time(NULL)) << "] " 
-              << "Client " << nickname << " disconnected: " << reason 
-              << " (fd: " << clientFd << ") - Total: " << _currentConnections 
-              << "/" << _maxClients << RESET << std::endl;
+    if (client->isRegistered() && _logger.isEnabled(LOG_DEBUG)) {
+        _logMessage(LOG_DEBUG, client->getNickname() + ": " + std::string(line, length));
+    }
     
-    _logMessage("INFO", "Client " + nickname + " disconnected: " + reason);
-    _cleanupEmptyChannels();
+    IrcMessage message;
+    if (!message.parse(line, length)) {
+        client->chargeFloodTokens(1);
+        return;
+    }
+    _parseCommand(client, message);
 }
 
-void Server::_processMessage(Client* client, const std::string& message) {
-    if (message.empty() || message.length() > 512) {
+void Server::_sendToClient(int clientFd, const std::string& message) {
+    Client* client = _findOwnedClient(clientFd);
+    if (!client) return;
+    
+    _sendToClient(client, message);
+}
+
+void Server::_sendToClient(Client* client, const std::string& message) {
+    if (message.empty()) return;
+    
+    Payload* payload = Payload::create(message);
+    _sendPayload(client, payload);
+    payload->release();
+}
+
+void Server::_sendPayload(Client* client, Payload* payload) {
+    Reactor* owner = _getReactor(client);
+    if (_currentReactor && owner != _currentReactor) {
+        owner->post(client->getFd(), client->getGeneration(), payload);
         return;
     }
     
-    if (client->isRegistered()) {
-        std::cout << BLUE << "[" << _formatTime(time(NULL)) << "] " 
-                  << client->getNickname() << ": " << message << RESET << std::endl;
+    if (client->isSendQExceeded()) {
+        __atomic_fetch_add(&_droppedWrites, 1ULL, __ATOMIC_RELAXED);
+        return;
     }
     
-    _parseCommand(client, message);
+    client->queueOutput(payload);
+    
+    if (client->getSendQueueBytes() > _sendQLimits[_getConnectionClass(client)]) {
+        __atomic_fetch_add(&_droppedWrites, 1ULL, __ATOMIC_RELAXED);
+        client->setSendQExceeded(true);
+        client->clearOutput();
+        owner->getClosingClients().push_back(client->getFd());
+        return;
+    }
+    
+    if (!_currentReactor) {
+        _flushClient(client);
+    } else if (!client->isFlushPending()) {
+        ClientRef ref = { client->getFd(), client->getGeneration() };
+        client->setFlushPending(true);
+        owner->getDirtyClients().push_back(ref);
+    }
+}
+
+Server::ConnectionClass Server::_getConnectionClass(Client* client) const {
+    if (client->isOperator()) return CLASS_OPERATOR;
+    if (client->isRegistered()) return CLASS_USER;
+    return CLASS_UNREGISTERED;
+}
+
+bool Server::setSendQLimit(const std::string& className, size_t bytes) {
+    for (size_t i = 0; i < CLASS_COUNT; i++) {
+        if (className == _classNames[i]) {
+            _sendQLimits[i] = bytes;
+            return true;
+        }
+    }
+    return false;
 }
 
-std::vector<std::string> Server::_splitMessage(const std::string& message) {
-    std::vector<std::string> tokens;
-    std::istringstream iss(message);
-    std::string token;
-    bool foundColon = false;
+void Server::_closeSendQExceeded(Reactor* reactor) {
+    std::vector<int>& closing = reactor->getClosingClients();
+    if (closing.empty()) return;
+    
+    for (size_t i = 0; i < closing.size(); i++) {
+        Client* client = _findOwnedClient(closing[i]);
+        if (client && client->isSendQExceeded()) {
+            _logMessage(LOG_WARNING, "SendQ limit exceeded for fd " + intToString(closing[i]));
+            _disconnectClient(closing[i], "Max SendQ exceeded");
+        }
+    }
+    closing.clear();
+}
+
+void Server::_flushDirtyClients(Reactor* reactor) {
+    std::vector<ClientRef>& dirty = reactor->getDirtyClients();
+    
+    const ClientTable& clients = reactor->getClients();
+    for (size_t i = 0; i < dirty.size(); i++) {
+        Client* client = clients.find(dirty[i].fd, dirty[i].generation);
+        if (!client) continue;
+        client->setFlushPending(false);
+        _flushClient(client);
+    }
+    dirty.clear();
+}
+
+bool Server::_flushClient(Client* client) {
+    struct iovec iov[64];
+    
+    Poller* poller = _getReactor(client)->getPoller();
+    if (poller->isCompletionBased()) {
+        if (client->hasPendingOutput() && !client->isOutputInFlight()) {
+            size_t count = client->fillOutputVector(iov, 64);
+            client->setOutputInFlight(poller->send(client->getFd(), iov, count));
+        }
+        return true;
+    }
     
-    while (iss >> token && !foundColon) {
-        if (token[0] == ':' && !tokens.empty()) {
-            std::string rest;
-            std::getline(iss, rest);
-            token += rest;
-            token = token.substr(1);
-            foundColon = true;
+    while (client->hasPendingOutput()) {
+        size_t count = client->fillOutputVector(iov, 64);
+        ssize_t sent = writev(client->getFd(), iov, static_cast<int>(count));
+        
+        if (sent > 0) {
+            client->consumeOutput(static_cast<size_t>(sent));
+            __atomic_fetch_add(&_bytesSent, static_cast<unsigned long long>(sent), __ATOMIC_RELAXED);
+            continue;
+        }
+        
+        if (sent == -1 && errno == EINTR) {
+            continue;
+        }
+        
+        if (sent == -1 && (errno == EWOULDBLOCK || errno == EAGAIN)) {
+            break;
         }
-        tokens.push_back(token);
+        
+        if (sent == -1 && errno != EPIPE) {
+            _logMessage(LOG_WARNING, "Send failed to fd " + intToString(client->getFd()) + ": " + strerror(errno));
+        }
+        __atomic_fetch_add(&_droppedWrites, 1ULL, __ATOMIC_RELAXED);
+        client->clearOutput();
+        _updatePollInterest(client);
+        return false;
     }
     
-    return tokens;
+    _updatePollInterest(client);
+    return true;
 }
 
-void Server::_sendToClient(int clientFd, const std::string& message) {
-    if (message.empty()) return;
+void Server::_updatePollInterest(Client* client) {
+    short events = 0;
+    if (!client->isThrottled() && !client->hasPendingInput()) events |= POLLIN;
+    if (client->hasPendingOutput()) events |= POLLOUT;
     
-    std::string fullMessage = message + "\r\n";
-    ssize_t sent = send(clientFd, fullMessage.c_str(), fullMessage.length(), MSG_NOSIGNAL);
+    if (events == client->getPollEvents()) return;
     
-    if (sent == -1) {
-        if (errno != EWOULDBLOCK && errno != EAGAIN && errno != EPIPE) {
-            _logMessage("WARNING", "Send failed to fd " + intToString(clientFd) + ": " + strerror(errno));
-        }
+    if (_getReactor(client)->getPoller()->modify(client->getFd(), events)) {
+        client->setPollEvents(events);
     }
 }
 
@@ -401,7 +966,7 @@ void Server::_sendNumericReply(Client* client, int code, const std::string& mess
     }
     
     oss << " " << message;
-    _sendToClient(client->getFd(), oss.str());
+    _sendToClient(client, oss.str());
 }
 
 bool Server::_isValidNickname(const std::string& nickname) {
@@ -445,48 +1010,106 @@ bool Server::_isValidChannelName(const std::string& channelName) {
     return true;
 }
 
-Channel* Server::_getOrCreateChannel(const std::string& channelName) {
-    Channel* channel = getChannel(channelName);
+bool Server::_setNickname(Client* client, const std::string& nickname) {
+    WriteLock lock(_nicknamesLock);
+    
+    Client* existingClient = getClientByNick(nickname);
+    if (existingClient && existingClient != client) {
+        return false;
+    }
+    
+    std::string oldNick = client->getNickname();
+    client->setNickname(nickname);
+    
+    if (client->getNickname() != oldNick) {
+        if (!oldNick.empty()) {
+            _nicknames.erase(foldName(oldNick));
+        }
+        _nicknames.insert(client->getFoldedNickname(), client);
+    }
+    return true;
+}
+
+Channel* Server::_retainChannel(const std::string& channelName, bool create) {
+    std::string foldedName = foldName(channelName);
+    Channel* channel = NULL;
+    
+    {
+        ReadLock lock(_channelsLock);
+        channel = _channels.find(foldedName);
+        if (channel || !create) {
+            if (channel) channel->retain();
+            return channel;
+        }
+    }
+    
+    WriteLock lock(_channelsLock);
+    channel = _channels.find(foldedName);
     if (!channel) {
         try {
-            channel = new Channel(channelName);
+            channel = new Channel(channelName, foldedName, _reactors.size());
             channel->setServer(this);
-            _channels[channelName] = channel;
-            _logMessage("INFO", "Channel created: " + channelName);
+            _channels.insert(foldedName, channel);
+            _logMessage(LOG_INFO, "Channel created: " + channelName);
         } catch (const std::bad_alloc& e) {
-            _logMessage("ERROR", "Failed to allocate memory for channel: " + channelName);
+            _logMessage(LOG_ERROR, "Failed to allocate memory for channel: " + channelName);
             return NULL;
         }
     }
+    channel->retain();
     return channel;
 }
 
-Client* Server::getClientByNick(const std::string& nickname) {
-    for (std::map<int, Client*>::iterator it = _clients.begin(); it != _clients.end(); ++it) {
-        if (it->second->getNickname() == nickname) {
-            return it->second;
-        }
+Channel* Server::_acquireChannel(const std::string& channelName, bool create) {
+    while (true) {
+        Channel* channel = _retainChannel(channelName, create);
+        if (!channel) return NULL;
+        
+        channel->lock();
+        if (!channel->isRemoved()) return channel;
+        channel->unlock();
+        channel->release();
     }
-    return NULL;
 }
 
-Channel* Server::getChannel(const std::string& channelName) {
-    std::map<std::string, Channel*>::iterator it = _channels.find(channelName);
-    return (it != _channels.end()) ? it->second : NULL;
+void Server::_retainChannels(std::vector<Channel*>& channels) {
+    ReadLock lock(_channelsLock);
+    
+    for (NameIndex<Channel>::const_iterator it = _channels.begin(); it != _channels.end(); ++it) {
+        it.value()->retain();
+        channels.push_back(it.value());
+    }
+}
+
+size_t Server::_getChannelCount() {
+    ReadLock lock(_channelsLock);
+    return _channels.size();
+}
+
+std::string Server::_getNamesReply(Channel* channel) {
+    ReadLock lock(_nicknamesLock);
+    return channel->getNamesReply();
+}
+
+Client* Server::getClientByNick(const std::string& nickname) {
+    return _nicknames.find(foldName(nickname));
 }
 
 std::vector<Channel*> Server::getChannelList() {
+    ReadLock lock(_channelsLock);
+    
     std::vector<Channel*> channels;
-    for (std::map<std::string, Channel*>::iterator it = _channels.begin(); it != _channels.end(); ++it) {
-        channels.push_back(it->second);
+    for (NameIndex<Channel>::const_iterator it = _channels.begin(); it != _channels.end(); ++it) {
+        channels.push_back(it.value());
     }
     return channels;
 }
 
 std::vector<Client*> Server::getClientList() {
     std::vector<Client*> clients;
-    for (std::map<int, Client*>::iterator it = _clients.begin(); it != _clients.end(); ++it) {
-        clients.push_back(it->second);
+    for (size_t i = 0; i < _reactors.size(); i++) {
+        MutexLock lock(_reactors[i]->getClientsMutex());
+        clients.insert(clients.end(), _reactors[i]->getClients().begin(), _reactors[i]->getClients().end());
     }
     return clients;
 }
@@ -496,9 +1119,10 @@ bool Server::isValidPassword(const std::string& password) const {
 }
 
 std::string Server::_formatTime(time_t timestamp) {
-    struct tm* timeinfo = localtime(&timestamp);
+    struct tm timeinfo;
+    localtime_r(&timestamp, &timeinfo);
     char buffer[20];
-    strftime(buffer, sizeof(buffer), "%H:%M:%S", timeinfo);
+    strftime(buffer, sizeof(buffer), "%H:%M:%S", &timeinfo);
     return std::string(buffer);
 }
 
@@ -521,69 +1145,73 @@ std::string Server::_getUptime() {
     return oss.str();
 }
 
-void Server::_logMessage(const std::string& level, const std::string& message) {
-    std::string color = WHITE;
-    if (level == "ERROR" || level == "FATAL") color = RED;
-    else if (level == "WARNING") color = YELLOW;
-    else if (level == "INFO") color = GREEN;
-    
-    std::cout << color << "[" << _formatTime(time(NULL)) << "] [" << level << "] " 
-              << message << RESET << std::endl;
+void Server::_logMessage(LogLevel level, const std::string& message) {
+    _logger.log(level, message);
 }
 
-void Server::_validateClientInput(Client* client, const std::string& input) {
-    if (input.length() > 512) {
-        _disconnectClient(client->getFd(), "Input line too long");
-        return;
-    }
-    
-    for (size_t i = 0; i < input.length(); i++) {
-        unsigned char c = static_cast<unsigned char>(input[i]);
+void Server::_validateClientInput(Client* client, const char* line, size_t length) {
+    for (size_t i = 0; i < length; i++) {
+        unsigned char c = static_cast<unsigned char>(line[i]);
         if (c < 32 && c != 9 && c != 10 && c != 13) {
-            _logMessage("WARNING", "Invalid character in input from " + client->getNickname());
+            _logMessage(LOG_WARNING, "Invalid character in input from " + client->getNickname());
             break;
         }
     }
 }
 
 bool Server::_rateLimitCheck(Client* client) {
-    (void)client;
-    return true;
-}
-
-bool Server::_isClientFlooding(Client* client) {
-    if (client->getBuffer().length() > 8192) {
+    if (_floodRate <= 0) {
         return true;
     }
-    return false;
+    
+    client->refillFloodTokens(monotonicSeconds(), _floodRate, _floodBurst);
+    return client->getFloodTokens() > 0;
 }
 
-void Server::_cleanupEmptyChannels() {
-    std::vector<std::string> emptyChannels;
-    
-    for (std::map<std::string, Channel*>::iterator it = _channels.begin(); it != _channels.end(); ++it) {
-        if (it->second->isEmpty()) {
-            emptyChannels.push_back(it->first);
-        }
-    }
+bool Server::_partChannel(Client* client, Channel* channel) {
+    client->leaveChannel(channel);
+    return _removeChannelIfEmpty(channel);
+}
+
+bool Server::_removeChannelIfEmpty(Channel* channel) {
+    if (!channel->isEmpty() || channel->isRemoved()) return false;
     
-    for (size_t i = 0; i < emptyChannels.size(); i++) {
-        std::map<std::string, Channel*>::iterator it = _channels.find(emptyChannels[i]);
-        if (it != _channels.end()) {
-            delete it->second;
-            _channels.erase(it);
-            _logMessage("INFO", "Empty channel removed: " + emptyChannels[i]);
-        }
+    {
+        WriteLock lock(_channelsLock);
+        _channels.erase(channel->getFoldedName());
     }
+    channel->setRemoved(true);
+    channel->release();
+    _logMessage(LOG_INFO, "Empty channel removed: " + channel->getName());
+    return true;
 }
 
 void Server::_sendToChannel(Channel* channel, const std::string& message, Client* exclude) {
     if (!channel) return;
     
-    const std::set<Client*>& clients = channel->getClients();
-    for (std::set<Client*>::const_iterator it = clients.begin(); it != clients.end(); ++it) {
-        if (*it != exclude) {
-            _sendToClient((*it)->getFd(), message);
+    if (message.empty()) return;
+    
+    Payload* payload = Payload::create(message);
+    unsigned long long excluded = exclude ? exclude->getId() : 0;
+    
+    for (size_t i = 0; i < _reactors.size(); i++) {
+        if (channel->getLocalMembers(i).empty()) continue;
+        
+        if (_currentReactor && _reactors[i] != _currentReactor) {
+            _reactors[i]->postChannel(channel, payload, excluded);
+        } else {
+            _sendToLocalMembers(channel, i, payload, excluded);
+        }
+    }
+    
+    payload->release();
+}
+
+void Server::_sendToLocalMembers(Channel* channel, size_t reactor, Payload* payload, unsigned long long exclude) {
+    const ClientSet& members = channel->getLocalMembers(reactor);
+    for (ClientSet::const_iterator it = members.begin(); it != members.end(); ++it) {
+        if ((*it)->getId() != exclude) {
+            _sendPayload(*it, payload);
         }
     }
 }
@@ -592,6 +1220,10 @@ void Server::sendToClient(int clientFd, const std::string& message) {
     _sendToClient(clientFd, message);
 }
 
+void Server::sendToChannel(Channel* channel, const std::string& message, Client* exclude) {
+    _sendToChannel(channel, message, exclude);
+}
+
 void Server::_sendWelcomeSequence(Client* client) {
     std::string nick = client->getNickname();
     std::string user = client->getUsername();
@@ -601,11 +1233,17 @@ void Server::_sendWelcomeSequence(Client* client) {
     _sendNumericReply(client, RPL_YOURHOST, ":Your host is " + _serverName + ", running version " + _serverVersion);
     _sendNumericReply(client, RPL_CREATED, ":This server was created " + _creationDate);
     _sendNumericReply(client, RPL_MYINFO, _serverName + " " + _serverVersion + " o itkol");
+    _sendISupport(client);
     
     _sendMotd(client);
     
-    std::cout << GREEN << "[" << _formatTime(time(NULL)) << "] " 
-              << "User " << nick << " registered successfully" << RESET << std::endl;
+    _logMessage(LOG_INFO, "User " + nick + " registered successfully");
+}
+
+void Server::_sendISupport(Client* client) {
+    std::string tokens = std::string("CASEMAPPING=") + caseMappingName(_caseMapping)
+        + " CHANTYPES=#& NICKLEN=9 CHANNELLEN=50 TOPICLEN=307";
+    _sendNumericReply(client, RPL_ISUPPORT, tokens + " :are supported by this server");
 }
 
 void Server::_sendMotd(Client* client) {
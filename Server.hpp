@@ -17,6 +17,7 @@
 #include <sys/socket.h>
 #include <sys/types.h>
 #include <netinet/in.h>
+#include <netinet/tcp.h>
 #include <arpa/inet.h>
 #include <netdb.h>
 #include <unistd.h>
@@ -24,6 +25,18 @@
 #include <poll.h>
 #include <signal.h>
 
+#include "Poller.hpp"
+#include "Payload.hpp"
+#include "NameIndex.hpp"
+#include "ClientTable.hpp"
+#include "Histogram.hpp"
+#include "Logger.hpp"
+#include "CaseMapping.hpp"
+#include "IrcMessage.hpp"
+#include "Clock.hpp"
+#include "Mutex.hpp"
+#include "Reactor.hpp"
+
 class Client;
 class Channel;
 
@@ -38,33 +51,117 @@ class Channel;
 #define BOLD    "\033[1m"
 
 class Server {
+    friend class MicroBench;
+    
 private:
+    typedef void (Server::*CommandHandler)(Client* client, const std::vector<std::string>& params);
+    
+    enum ConnectionClass {
+        CLASS_UNREGISTERED,
+        CLASS_USER,
+        CLASS_OPERATOR,
+        CLASS_COUNT
+    };
+    
+    enum CommandFlags {
+        CMD_REQUIRES_PASSWORD = 1,
+        CMD_REQUIRES_REGISTRATION = 2,
+        CMD_REJECTS_REGISTERED = 4
+    };
+    
+    struct CommandEntry {
+        const char* name;
+        CommandHandler handler;
+        int flags;
+        size_t minParams;
+        unsigned int cost;
+    };
+    
+    struct MetricsConnection {
+        std::string input;
+        std::string output;
+        double openedAt;
+    };
+    
+    static const size_t METRICS_MAX_CONNECTIONS = 16;
+    static const size_t METRICS_MAX_REQUEST = 8192;
+    static const unsigned int METRICS_TIMEOUT = 10;
+    
+    static const char* const _classNames[CLASS_COUNT];
+    static const CommandEntry _commandTable[];
+    static const size_t _commandCount;
+    
     int _port;
     std::string _password;
-    int _serverSocket;
-    bool _running;
+    volatile bool _running;
+    Logger _logger;
     
-    std::vector<struct pollfd> _pollFds;
-    std::map<int, Client*> _clients;
-    std::map<std::string, Channel*> _channels;
+    std::vector<Reactor*> _reactors;
+    size_t _reactorCount;
+    std::string _pollBackend;
+    RwLock _nicknamesLock;
+    NameIndex<Client> _nicknames;
+    RwLock _channelsLock;
+    NameIndex<Channel> _channels;
+    CaseMapping _caseMapping;
     
     std::string _serverName;
     std::string _serverVersion;
     std::string _creationDate;
     std::string _motd;
     size_t _maxClients;
+    size_t _acceptBatch;
+    int _listenBacklog;
+    size_t _sendQLimits[CLASS_COUNT];
+    unsigned int _registrationTimeout;
+    unsigned int _pingInterval;
+    unsigned int _pingTimeout;
+    double _floodBurst;
+    double _floodRate;
     
     size_t _totalConnections;
     size_t _currentConnections;
+    unsigned long long _nextClientId;
     time_t _startTime;
+    unsigned long long _bytesReceived;
+    unsigned long long _bytesSent;
+    unsigned long long _droppedWrites;
+    
+    int _metricsPort;
+    int _metricsFd;
+    std::map<int, MetricsConnection> _metricsConnections;
+    
+    
+    static __thread Reactor* _currentReactor;
     
     void _setupSocket();
-    void _acceptNewClient();
+    int _createListenSocket(int port, in_addr_t address, bool reusePort);
+    static void* _reactorMain(void* arg);
+    void _runReactor(Reactor* reactor);
+    void _wakeReactors();
+    Reactor* _getReactor(Client* client) const;
+    Client* _findOwnedClient(int clientFd);
+    bool _acceptNewClient(Reactor* reactor);
+    void _acceptCompleted(Reactor* reactor, int result);
+    void _registerClient(Reactor* reactor, int clientFd, const struct sockaddr_in& clientAddr);
     void _handleClientData(int clientFd);
+    void _handleClientReceive(int clientFd, const char* data, int result);
+    void _handleClientWrite(int clientFd);
+    void _handleClientSent(int clientFd, int result);
+    bool _processClientInput(Client* client);
+    void _processDeliveries(Reactor* reactor, std::vector<Delivery>& deliveries);
+    void _processThrottledClients(Reactor* reactor);
+    void _processTimers(Reactor* reactor, std::vector<TimerNode*>& expired);
+    void _scheduleClientTimer(Client* client, double delay);
+    void _handleClientTimer(Client* client, double now);
+    int _getLoopTimeout(Reactor* reactor);
     void _removeClient(int clientFd);
-    void _processMessage(Client* client, const std::string& message);
-    void _parseCommand(Client* client, const std::string& command);
+    void _processMessage(Client* client, const char* line, size_t length);
+    void _parseCommand(Client* client, const IrcMessage& message);
+    void _dispatchCommand(Client* client, const CommandEntry* entry, const IrcMessage& message);
+    const CommandEntry* _findCommand(const char* name) const;
     
+    void _handleCap(Client* client, const std::vector<std::string>& params);
     void _handlePass(Client* client, const std::vector<std::string>& params);
     void _handleNick(Client* client, const std::vector<std::string>& params);
     void _handleUser(Client* client, const std::vector<std::string>& params);
@@ -88,32 +185,58 @@ private:
     void _handleInfo(Client* client, const std::vector<std::string>& params);
     void _handleStats(Client* client, const std::vector<std::string>& params);
     
-    std::vector<std::string> _splitMessage(const std::string& message);
     void _sendToClient(int clientFd, const std::string& message);
+    void _sendToClient(Client* client, const std::string& message);
+    void _sendPayload(Client* client, Payload* payload);
+    bool _flushClient(Client* client);
+    ConnectionClass _getConnectionClass(Client* client) const;
+    void _closeSendQExceeded(Reactor* reactor);
+    void _flushDirtyClients(Reactor* reactor);
+    void _updatePollInterest(Client* client);
     void _sendToChannel(Channel* channel, const std::string& message, Client* exclude = NULL);
+    void _sendToLocalMembers(Channel* channel, size_t reactor, Payload* payload, unsigned long long exclude);
     bool _isValidNickname(const std::string& nickname);
     bool _isValidChannelName(const std::string& channelName);
     bool _isChannelOperator(Client* client, Channel* channel);
-    Channel* _getOrCreateChannel(const std::string& channelName);
+    bool _setNickname(Client* client, const std::string& nickname);
+    Channel* _retainChannel(const std::string& channelName, bool create);
+    Channel* _acquireChannel(const std::string& channelName, bool create);
+    void _retainChannels(std::vector<Channel*>& channels);
+    size_t _getChannelCount();
+    std::string _getNamesReply(Channel* channel);
     std::string _formatTime(time_t timestamp);
     std::string _getUptime();
-    void _logMessage(const std::string& level, const std::string& message);
-    void _validateClientInput(Client* client, const std::string& input);
+    void _logMessage(LogLevel level, const std::string& message);
+    void _validateClientInput(Client* client, const char* line, size_t length);
     bool _rateLimitCheck(Client* client);
     
     void _sendNumericReply(Client* client, int code, const std::string& message);
     void _sendWelcomeSequence(Client* client);
+    void _sendISupport(Client* client);
     void _sendMotd(Client* client);
     void _sendChannelModes(Client* client, Channel* channel);
     void _sendWhoReply(Client* client, Channel* channel, Client* target);
-    void _sendWhoisReply(Client* client, Client* target);
+    bool _sendWhoisReply(Client* client, const std::string& nickname);
     void _sendListReply(Client* client, Channel* channel);
     void _sendStatsReply(Client* client);
+    void _sendStatsLinkInfo(Client* client);
+    void _sendLinkInfoLine(Client* client, Client* target);
+    void _sendStatsCommands(Client* client);
+    void _collectCommandTimes(size_t command, Histogram& total) const;
     
-    void _cleanupEmptyChannels();
-    bool _isClientFlooding(Client* client);
+    bool _partChannel(Client* client, Channel* channel);
+    bool _removeChannelIfEmpty(Channel* channel);
     void _disconnectClient(int clientFd, const std::string& reason);
     
+    void _setupMetricsSocket();
+    bool _isMetricsConnection(Reactor* reactor, int fd) const;
+    void _acceptMetricsClients();
+    void _handleMetricsEvent(int fd, short revents);
+    void _closeMetricsConnection(int fd);
+    void _expireMetricsConnections(Reactor* reactor);
+    std::string _buildMetricsResponse(const std::string& request);
+    std::string _renderMetrics();
+    
 public:
     Server(int port, const std::string& password);
     ~Server();
@@ -127,21 +250,38 @@ public:
     const std::string& getServerVersion() const { return _serverVersion; }
     const std::string& getMotd() const { return _motd; }
     size_t getMaxClients() const { return _maxClients; }
-    size_t getTotalConnections() const { return _totalConnections; }
-    size_t getCurrentConnections() const { return _currentConnections; }
+    const std::string& getPollBackend() const { return _pollBackend; }
+    size_t getReactorCount() const { return _reactorCount; }
+    CaseMapping getCaseMapping() const { return _caseMapping; }
+    size_t getTotalConnections() const { return __atomic_load_n(&_totalConnections, __ATOMIC_RELAXED); }
+    size_t getCurrentConnections() const { return __atomic_load_n(&_currentConnections, __ATOMIC_RELAXED); }
     time_t getStartTime() const { return _startTime; }
+    Logger& getLogger() { return _logger; }
     
     Client* getClientByNick(const std::string& nickname);
-    Channel* getChannel(const std::string& channelName);
     std::vector<Channel*> getChannelList();
     std::vector<Client*> getClientList();
     
     void setMotd(const std::string& motd) { _motd = motd; }
     void setMaxClients(size_t maxClients) { _maxClients = maxClients; }
+    void setAcceptBatch(size_t batch) { _acceptBatch = batch; }
+    void setListenBacklog(int backlog) { _listenBacklog = backlog; }
+    void setPollBackend(const std::string& backend) { _pollBackend = backend; }
+    void setReactorCount(size_t count) { _reactorCount = count; }
+    void setCaseMapping(CaseMapping mapping) { _caseMapping = mapping; }
+    bool setSendQLimit(const std::string& className, size_t bytes);
+    void setRegistrationTimeout(unsigned int seconds) { _registrationTimeout = seconds; }
+    void setPingInterval(unsigned int seconds) { _pingInterval = seconds; }
+    void setPingTimeout(unsigned int seconds) { _pingTimeout = seconds; }
+    void setFloodBurst(double burst) { _floodBurst = burst; }
+    void setFloodRate(double rate) { _floodRate = rate; }
+    void setMetricsPort(int port) { _metricsPort = port; }
     
     bool isRunning() const { return _running; }
     bool isValidPassword(const std::string& password) const;
+    std::string foldName(const std::string& name) const { return caseFold(name, _caseMapping); }
     void sendToClient(int clientFd, const std::string& message);
+    void sendToChannel(Channel* channel, const std::string& message, Client* exclude = NULL);
     
     static Server* instance;
     static void signalHandler(int signum);
@@ -152,6 +292,7 @@ public:
 #define RPL_CREATED 003
 #define RPL_MYINFO 004
 #define RPL_BOUNCE 005
+#define RPL_ISUPPORT 005
 #define RPL_USERHOST 302
 #define RPL_ISON 303
 #define RPL_AWAY 301
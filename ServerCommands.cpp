@@ -5,84 +5,124 @@
 extern std::string intToString(int value);
 extern std::string sizeToString(size_t value);
 
-void Server::_parseCommand(Client* client, const std::string& command) {
-    std::vector<std::string> tokens = _splitMessage(command);
-    if (tokens.empty()) return;
+const Server::CommandEntry Server::_commandTable[] = {
+    { "ADMIN",   &Server::_handleAdmin,   CMD_REQUIRES_REGISTRATION, 0, 1 },
+    { "CAP",     &Server::_handleCap,     0, 0, 1 },
+    { "INFO",    &Server::_handleInfo,    CMD_REQUIRES_REGISTRATION, 0, 1 },
+    { "INVITE",  &Server::_handleInvite,  CMD_REQUIRES_REGISTRATION, 2, 2 },
+    { "JOIN",    &Server::_handleJoin,    CMD_REQUIRES_REGISTRATION, 1, 2 },
+    { "KICK",    &Server::_handleKick,    CMD_REQUIRES_REGISTRATION, 2, 1 },
+    { "LIST",    &Server::_handleList,    CMD_REQUIRES_REGISTRATION, 0, 4 },
+    { "MODE",    &Server::_handleMode,    CMD_REQUIRES_REGISTRATION, 1, 1 },
+    { "MOTD",    &Server::_handleMotd,    CMD_REQUIRES_REGISTRATION, 0, 1 },
+    { "NAMES",   &Server::_handleNames,   CMD_REQUIRES_REGISTRATION, 0, 3 },
+    { "NICK",    &Server::_handleNick,    CMD_REQUIRES_PASSWORD, 0, 2 },
+    { "PART",    &Server::_handlePart,    CMD_REQUIRES_REGISTRATION, 1, 1 },
+    { "PASS",    &Server::_handlePass,    CMD_REJECTS_REGISTERED, 1, 1 },
+    { "PING",    &Server::_handlePing,    0, 0, 1 },
+    { "PONG",    NULL,                    0, 0, 1 },
+    { "PRIVMSG", &Server::_handlePrivmsg, CMD_REQUIRES_REGISTRATION, 0, 1 },
+    { "QUIT",    &Server::_handleQuit,    0, 0, 1 },
+    { "STATS",   &Server::_handleStats,   CMD_REQUIRES_REGISTRATION, 0, 4 },
+    { "TIME",    &Server::_handleTime,    CMD_REQUIRES_REGISTRATION, 0, 1 },
+    { "TOPIC",   &Server::_handleTopic,   CMD_REQUIRES_REGISTRATION, 1, 1 },
+    { "USER",    &Server::_handleUser,    CMD_REQUIRES_PASSWORD | CMD_REJECTS_REGISTERED, 4, 1 },
+    { "VERSION", &Server::_handleVersion, CMD_REQUIRES_REGISTRATION, 0, 1 },
+    { "WHO",     &Server::_handleWho,     CMD_REQUIRES_REGISTRATION, 1, 3 },
+    { "WHOIS",   &Server::_handleWhois,   CMD_REQUIRES_REGISTRATION, 1, 2 }
+};
+
+const size_t Server::_commandCount = sizeof(_commandTable) / sizeof(_commandTable[0]);
+
+const Server::CommandEntry* Server::_findCommand(const char* name) const {
+    size_t low = 0;
+    size_t high = _commandCount;
+    
+    while (low < high) {
+        size_t mid = (low + high) / 2;
+        int cmp = strcmp(name, _commandTable[mid].name);
+        if (cmp == 0) {
+            return &_commandTable[mid];
+        }
+        if (cmp < 0) {
+            high = mid;
+        } else {
+            low = mid + 1;
+        }
+    }
+    return NULL;
+}
+
+void Server::_parseCommand(Client* client, const IrcMessage& message) {
+    const Token& command = message.getCommand();
+    char verb[16];
+    const CommandEntry* entry = NULL;
     
-    std::string cmd = tokens[0];
-    std::transform(cmd.begin(), cmd.end(), cmd.begin(), ::toupper);
+    if (command.length < sizeof(verb)) {
+        for (size_t i = 0; i < command.length; i++) {
+            verb[i] = static_cast<char>(toupper(static_cast<unsigned char>(command.data[i])));
+        }
+        verb[command.length] = '\0';
+        entry = _findCommand(verb);
+    }
     
-    std::vector<std::string> params(tokens.begin() + 1, tokens.end());
+    client->chargeFloodTokens(entry ? entry->cost : 1);
     
-    if (cmd == "CAP") {
-        if (!params.empty() && params[0] == "LS") {
-            _sendToClient(client->getFd(), "CAP * LS :");
+    if (!entry) {
+        if (client->isRegistered()) {
+            std::string cmd = command.str();
+            std::transform(cmd.begin(), cmd.end(), cmd.begin(), ::toupper);
+            _sendNumericReply(client, ERR_UNKNOWNCOMMAND, cmd + " :Unknown command");
         }
         return;
     }
     
-    if (cmd == "PASS") {
-        _handlePass(client, params);
-    } else if (cmd == "NICK") {
-        _handleNick(client, params);
-    } else if (cmd == "USER") {
-        _handleUser(client, params);
-    } else if (cmd == "JOIN") {
-        _handleJoin(client, params);
-    } else if (cmd == "PART") {
-        _handlePart(client, params);
-    } else if (cmd == "PRIVMSG") {
-        _handlePrivmsg(client, params);
-    } else if (cmd == "QUIT") {
-        _handleQuit(client, params);
-    } else if (cmd == "PING") {
-        _handlePing(client, params);
-    } else if (cmd == "PONG") {
-        return;
-    } else if (cmd == "KICK") {
-        _handleKick(client, params);
-    } else if (cmd == "INVITE") {
-        _handleInvite(client, params);
-    } else if (cmd == "TOPIC") {
-        _handleTopic(client, params);
-    } else if (cmd == "MODE") {
-        _handleMode(client, params);
-    } else if (cmd == "WHO") {
-        _handleWho(client, params);
-    } else if (cmd == "WHOIS") {
-        _handleWhois(client, params);
-    } else if (cmd == "LIST") {
-        _handleList(client, params);
-    } else if (cmd == "NAMES") {
-        _handleNames(client, params);
-    } else if (cmd == "MOTD") {
-        _handleMotd(client, params);
-    } else if (cmd == "ADMIN") {
-        _handleAdmin(client, params);
-    } else if (cmd == "TIME") {
-        _handleTime(client, params);
-    } else if (cmd == "VERSION") {
-        _handleVersion(client, params);
-    } else if (cmd == "INFO") {
-        _handleInfo(client, params);
-    } else if (cmd == "STATS") {
-        _handleStats(client, params);
-    } else if (client->isRegistered()) {
-        _sendNumericReply(client, ERR_UNKNOWNCOMMAND, cmd + " :Unknown command");
-    }
+    unsigned long long started = monotonicNanoseconds();
+    _dispatchCommand(client, entry, message);
+    _currentReactor->getCommandTimes()[entry - _commandTable].record(monotonicNanoseconds() - started);
 }
 
-void Server::_handlePass(Client* client, const std::vector<std::string>& params) {
-    if (client->isRegistered()) {
+void Server::_dispatchCommand(Client* client, const CommandEntry* entry, const IrcMessage& message) {
+    if ((entry->flags & CMD_REQUIRES_PASSWORD) && !client->hasPasswordProvided() && !_password.empty()) {
+        _sendNumericReply(client, ERR_NOTREGISTERED, ":Password required");
+        return;
+    }
+    
+    if ((entry->flags & CMD_REQUIRES_REGISTRATION) && !client->isRegistered()) {
+        _sendNumericReply(client, ERR_NOTREGISTERED, ":You have not registered");
+        return;
+    }
+    
+    if ((entry->flags & CMD_REJECTS_REGISTERED) && client->isRegistered()) {
         _sendNumericReply(client, ERR_ALREADYREGISTRED, ":You may not reregister");
         return;
     }
     
-    if (params.empty()) {
-        _sendNumericReply(client, ERR_NEEDMOREPARAMS, "PASS :Not enough parameters");
+    if (message.getParamCount() < entry->minParams) {
+        _sendNumericReply(client, ERR_NEEDMOREPARAMS, std::string(entry->name) + " :Not enough parameters");
         return;
     }
     
+    if (!entry->handler) {
+        return;
+    }
+    
+    std::vector<std::string>& params = _currentReactor->getParams();
+    params.resize(message.getParamCount());
+    for (size_t i = 0; i < message.getParamCount(); i++) {
+        message.getParam(i).assignTo(params[i]);
+    }
+    
+    (this->*(entry->handler))(client, params);
+}
+
+void Server::_handleCap(Client* client, const std::vector<std::string>& params) {
+    if (!params.empty() && params[0] == "LS") {
+        _sendToClient(client->getFd(), "CAP * LS :");
+    }
+}
+
+void Server::_handlePass(Client* client, const std::vector<std::string>& params) {
     if (isValidPassword(params[0])) {
         client->setPasswordProvided(true);
         client->tryRegister();
@@ -91,16 +131,11 @@ void Server::_handlePass(Client* client, const std::vector<std::string>& params)
         }
     } else {
         _sendNumericReply(client, ERR_PASSWDMISMATCH, ":Password incorrect");
-        _logMessage("WARNING", "Invalid password attempt from " + client->getHostname());
+        _logMessage(LOG_WARNING, "Invalid password attempt from " + client->getHostname());
     }
 }
 
 void Server::_handleNick(Client* client, const std::vector<std::string>& params) {
-    if (!client->hasPasswordProvided() && !_password.empty()) {
-        _sendNumericReply(client, ERR_NOTREGISTERED, ":Password required");
-        return;
-    }
-    
     if (params.empty()) {
         _sendNumericReply(client, ERR_NONICKNAMEGIVEN, ":No nickname given");
         return;
@@ -113,32 +148,36 @@ void Server::_handleNick(Client* client, const std::vector<std::string>& params)
         return;
     }
     
-    Client* existingClient = getClientByNick(newNick);
-    if (existingClient && existingClient != client) {
+    std::string oldNick = client->getNickname();
+    if (!_setNickname(client, newNick)) {
         _sendNumericReply(client, ERR_NICKNAMEINUSE, newNick + " :Nickname is already in use");
         return;
     }
     
-    std::string oldNick = client->getNickname();
-    client->setNickname(newNick);
-    
     if (client->isRegistered()) {
         std::string nickMsg = ":" + oldNick + "!" + client->getUsername() + "@" + client->getHostname() + " NICK :" + newNick;
         
-        std::set<Channel*> channels = client->getChannels();
+        std::vector<Channel*> channels;
+        client->collectChannels(channels);
         std::set<Client*> notifiedClients;
-        
-        for (std::set<Channel*>::iterator it = channels.begin(); it != channels.end(); ++it) {
-            const std::set<Client*>& channelClients = (*it)->getClients();
-            for (std::set<Client*>::const_iterator cIt = channelClients.begin(); cIt != channelClients.end(); ++cIt) {
+        Payload* payload = Payload::create(nickMsg);
+        
+        for (size_t i = 0; i < channels.size(); i++) {
+            channels[i]->lock();
+            ChannelLock channelLock(channels[i]);
+            if (!channels[i]->hasClient(client)) continue;
+            const ClientSet& channelClients = channels[i]->getClients();
+            for (ClientSet::const_iterator cIt = channelClients.begin(); cIt != channelClients.end(); ++cIt) {
                 if (notifiedClients.find(*cIt) == notifiedClients.end()) {
-                    _sendToClient((*cIt)->getFd(), nickMsg);
+                    _sendPayload(*cIt, payload);
                     notifiedClients.insert(*cIt);
                 }
             }
         }
         
-        _logMessage("INFO", "Nick change: " + oldNick + " -> " + newNick);
+        payload->release();
+        
+        _logMessage(LOG_INFO, "Nick change: " + oldNick + " -> " + newNick);
     } else {
         client->tryRegister();
         if (client->isRegistered()) {
@@ -148,24 +187,12 @@ void Server::_handleNick(Client* client, const std::vector<std::string>& params)
 }
 
 void Server::_handleUser(Client* client, const std::vector<std::string>& params) {
-    if (!client->hasPasswordProvided() && !_password.empty()) {
-        _sendNumericReply(client, ERR_NOTREGISTERED, ":Password required");
-        return;
+    {
+        WriteLock lock(_nicknamesLock);
+        client->setUsername(params[0]);
+        client->setRealname(params[3]);
     }
     
-    if (client->isRegistered()) {
-        _sendNumericReply(client, ERR_ALREADYREGISTRED, ":You may not reregister");
-        return;
-    }
-    
-    if (params.size() < 4) {
-        _sendNumericReply(client, ERR_NEEDMOREPARAMS, "USER :Not enough parameters");
-        return;
-    }
-    
-    client->setUsername(params[0]);
-    client->setRealname(params[3]);
-    
     client->tryRegister();
     if (client->isRegistered()) {
         _sendWelcomeSequence(client);
@@ -173,16 +200,6 @@ void Server::_handleUser(Client* client, const std::vector<std::string>& params)
 }
 
 void Server::_handleJoin(Client* client, const std::vector<std::string>& params) {
-    if (!client->isRegistered()) {
-        _sendNumericReply(client, ERR_NOTREGISTERED, ":You have not registered");
-        return;
-    }
-    
-    if (params.empty()) {
-        _sendNumericReply(client, ERR_NEEDMOREPARAMS, "JOIN :Not enough parameters");
-        return;
-    }
-    
     std::string channelList = params[0];
     std::string keyList = (params.size() > 1) ? params[1] : "";
     
@@ -218,16 +235,18 @@ void Server::_handleJoin(Client* client, const std::vector<std::string>& params)
             continue;
         }
         
-        if (client->getChannels().size() >= 20) {
+        if (!client->canJoinMoreChannels()) {
             _sendNumericReply(client, ERR_TOOMANYCHANNELS, channelName + " :You have joined too many channels");
             break;
         }
         
-        Channel* ch = _getOrCreateChannel(channelName);
+        Channel* ch = _acquireChannel(channelName, true);
+        ChannelLock channelLock(ch);
         if (!ch) {
             _sendNumericReply(client, ERR_NOSUCHCHANNEL, channelName + " :Channel creation failed");
             continue;
         }
+        channelName = ch->getName();
         
         if (ch->hasClient(client)) {
             continue;
@@ -243,6 +262,7 @@ void Server::_handleJoin(Client* client, const std::vector<std::string>& params)
             } else {
                 _sendNumericReply(client, ERR_CANNOTSENDTOCHAN, channelName + " :Cannot join channel");
             }
+            _removeChannelIfEmpty(ch);
             continue;
         }
         
@@ -258,24 +278,14 @@ void Server::_handleJoin(Client* client, const std::vector<std::string>& params)
             _sendNumericReply(client, RPL_NOTOPIC, channelName + " :No topic is set");
         }
         
-        _sendNumericReply(client, RPL_NAMREPLY, "= " + channelName + " :" + ch->getNamesReply());
+        _sendNumericReply(client, RPL_NAMREPLY, "= " + channelName + " :" + _getNamesReply(ch));
         _sendNumericReply(client, RPL_ENDOFNAMES, channelName + " :End of /NAMES list");
         
-        _logMessage("INFO", client->getNickname() + " joined " + channelName);
+        _logMessage(LOG_INFO, client->getNickname() + " joined " + channelName);
     }
 }
 
 void Server::_handlePart(Client* client, const std::vector<std::string>& params) {
-    if (!client->isRegistered()) {
-        _sendNumericReply(client, ERR_NOTREGISTERED, ":You have not registered");
-        return;
-    }
-    
-    if (params.empty()) {
-        _sendNumericReply(client, ERR_NEEDMOREPARAMS, "PART :Not enough parameters");
-        return;
-    }
-    
     std::string channelList = params[0];
     std::string reason = (params.size() > 1) ? params[1] : "Leaving";
     
@@ -285,26 +295,22 @@ void Server::_handlePart(Client* client, const std::vector<std::string>& params)
     while (std::getline(channelStream, channelName, ',')) {
         if (channelName.empty()) continue;
         
-        Channel* channel = getChannel(channelName);
+        Channel* channel = _acquireChannel(channelName, false);
+        ChannelLock channelLock(channel);
         if (!channel || !channel->hasClient(client)) {
             _sendNumericReply(client, ERR_NOTONCHANNEL, channelName + " :You're not on that channel");
             continue;
         }
         
-        std::string partMsg = ":" + client->getPrefix() + " PART " + channelName + " :" + reason;
+        std::string partMsg = ":" + client->getPrefix() + " PART " + channel->getName() + " :" + reason;
         _sendToChannel(channel, partMsg);
         
-        client->leaveChannel(channel);
-        _logMessage("INFO", client->getNickname() + " left " + channelName + " (" + reason + ")");
+        _partChannel(client, channel);
+        _logMessage(LOG_INFO, client->getNickname() + " left " + channelName + " (" + reason + ")");
     }
 }
 
 void Server::_handlePrivmsg(Client* client, const std::vector<std::string>& params) {
-    if (!client->isRegistered()) {
-        _sendNumericReply(client, ERR_NOTREGISTERED, ":You have not registered");
-        return;
-    }
-    
     if (params.empty()) {
         _sendNumericReply(client, ERR_NORECIPIENT, ":No recipient given (PRIVMSG)");
         return;
@@ -330,7 +336,8 @@ void Server::_handlePrivmsg(Client* client, const std::vector<std::string>& para
         if (target.empty()) continue;
         
         if (target[0] == '#' || target[0] == '&') {
-            Channel* channel = getChannel(target);
+            Channel* channel = _acquireChannel(target, false);
+            ChannelLock channelLock(channel);
             if (!channel) {
                 _sendNumericReply(client, ERR_NOSUCHCHANNEL, target + " :No such channel");
                 continue;
@@ -346,9 +353,10 @@ void Server::_handlePrivmsg(Client* client, const std::vector<std::string>& para
                 continue;
             }
             
-            std::string privmsgMsg = ":" + client->getPrefix() + " PRIVMSG " + target + " :" + message;
+            std::string privmsgMsg = ":" + client->getPrefix() + " PRIVMSG " + channel->getName() + " :" + message;
             _sendToChannel(channel, privmsgMsg, client);
         } else {
+            ReadLock nickLock(_nicknamesLock);
             Client* targetClient = getClientByNick(target);
             if (!targetClient) {
                 _sendNumericReply(client, ERR_NOSUCHNICK, target + " :No such nick/channel");
@@ -356,7 +364,7 @@ void Server::_handlePrivmsg(Client* client, const std::vector<std::string>& para
             }
             
             std::string privmsgMsg = ":" + client->getPrefix() + " PRIVMSG " + target + " :" + message;
-            _sendToClient(targetClient->getFd(), privmsgMsg);
+            _sendToClient(targetClient, privmsgMsg);
         }
     }
 }
@@ -382,21 +390,12 @@ void Server::_handlePing(Client* client, const std::vector<std::string>& params)
 }
 
 void Server::_handleKick(Client* client, const std::vector<std::string>& params) {
-    if (!client->isRegistered()) {
-        _sendNumericReply(client, ERR_NOTREGISTERED, ":You have not registered");
-        return;
-    }
-    
-    if (params.size() < 2) {
-        _sendNumericReply(client, ERR_NEEDMOREPARAMS, "KICK :Not enough parameters");
-        return;
-    }
-    
     std::string channelName = params[0];
     std::string targetNicks = params[1];
     std::string reason = (params.size() > 2) ? params[2] : client->getNickname();
     
-    Channel* channel = getChannel(channelName);
+    Channel* channel = _acquireChannel(channelName, false);
+    ChannelLock channelLock(channel);
     if (!channel) {
         _sendNumericReply(client, ERR_NOSUCHCHANNEL, channelName + " :No such channel");
         return;
@@ -418,6 +417,7 @@ void Server::_handleKick(Client* client, const std::vector<std::string>& params)
     while (std::getline(nickStream, targetNick, ',')) {
         if (targetNick.empty()) continue;
         
+        ReadLock nickLock(_nicknamesLock);
         Client* targetClient = getClientByNick(targetNick);
         if (!targetClient) {
             _sendNumericReply(client, ERR_NOSUCHNICK, targetNick + " :No such nick");
@@ -429,29 +429,30 @@ void Server::_handleKick(Client* client, const std::vector<std::string>& params)
             continue;
         }
         
-        std::string kickMsg = ":" + client->getPrefix() + " KICK " + channelName + " " + targetNick + " :" + reason;
-        _sendToChannel(channel, kickMsg);
+        std::string kickMsg = ":" + client->getPrefix() + " KICK " + channel->getName() + " " + targetClient->getNickname() + " :" + reason;
+        _sendToChannel(channel, kickMsg, targetClient);
+        _sendToClient(targetClient, kickMsg);
         
-        targetClient->leaveChannel(channel);
-        _logMessage("INFO", client->getNickname() + " kicked " + targetNick + " from " + channelName + " (" + reason + ")");
+        bool removed;
+        Reactor* owner = _getReactor(targetClient);
+        if (owner != _currentReactor) {
+            owner->postPart(targetClient->getFd(), targetClient->getGeneration(), channel);
+            channel->removeClient(targetClient);
+            removed = _removeChannelIfEmpty(channel);
+        } else {
+            removed = _partChannel(targetClient, channel);
+        }
+        _logMessage(LOG_INFO, client->getNickname() + " kicked " + targetNick + " from " + channelName + " (" + reason + ")");
+        if (removed) break;
     }
 }
 
 void Server::_handleInvite(Client* client, const std::vector<std::string>& params) {
-    if (!client->isRegistered()) {
-        _sendNumericReply(client, ERR_NOTREGISTERED, ":You have not registered");
-        return;
-    }
-    
-    if (params.size() < 2) {
-        _sendNumericReply(client, ERR_NEEDMOREPARAMS, "INVITE :Not enough parameters");
-        return;
-    }
-    
     std::string targetNick = params[0];
     std::string channelName = params[1];
     
-    Channel* channel = getChannel(channelName);
+    Channel* channel = _acquireChannel(channelName, false);
+    ChannelLock channelLock(channel);
     if (!channel) {
         _sendNumericReply(client, ERR_NOSUCHCHANNEL, channelName + " :No such channel");
         return;
@@ -467,6 +468,7 @@ void Server::_handleInvite(Client* client, const std::vector<std::string>& param
         return;
     }
     
+    ReadLock nickLock(_nicknamesLock);
     Client* targetClient = getClientByNick(targetNick);
     if (!targetClient) {
         _sendNumericReply(client, ERR_NOSUCHNICK, targetNick + " :No such nick");
@@ -483,25 +485,16 @@ void Server::_handleInvite(Client* client, const std::vector<std::string>& param
     _sendNumericReply(client, RPL_INVITING, targetNick + " " + channelName);
     
     std::string inviteMsg = ":" + client->getPrefix() + " INVITE " + targetNick + " :" + channelName;
-    _sendToClient(targetClient->getFd(), inviteMsg);
+    _sendToClient(targetClient, inviteMsg);
     
-    _logMessage("INFO", client->getNickname() + " invited " + targetNick + " to " + channelName);
+    _logMessage(LOG_INFO, client->getNickname() + " invited " + targetNick + " to " + channelName);
 }
 
 void Server::_handleTopic(Client* client, const std::vector<std::string>& params) {
-    if (!client->isRegistered()) {
-        _sendNumericReply(client, ERR_NOTREGISTERED, ":You have not registered");
-        return;
-    }
-    
-    if (params.empty()) {
-        _sendNumericReply(client, ERR_NEEDMOREPARAMS, "TOPIC :Not enough parameters");
-        return;
-    }
-    
     std::string channelName = params[0];
     
-    Channel* channel = getChannel(channelName);
+    Channel* channel = _acquireChannel(channelName, false);
+    ChannelLock channelLock(channel);
     if (!channel) {
         _sendNumericReply(client, ERR_NOSUCHCHANNEL, channelName + " :No such channel");
         return;
@@ -531,28 +524,19 @@ void Server::_handleTopic(Client* client, const std::vector<std::string>& params
         
         channel->setTopic(newTopic, client);
         
-        std::string topicMsg = ":" + client->getPrefix() + " TOPIC " + channelName + " :" + newTopic;
+        std::string topicMsg = ":" + client->getPrefix() + " TOPIC " + channel->getName() + " :" + newTopic;
         _sendToChannel(channel, topicMsg);
         
-        _logMessage("INFO", client->getNickname() + " changed topic in " + channelName + " to: " + newTopic);
+        _logMessage(LOG_INFO, client->getNickname() + " changed topic in " + channelName + " to: " + newTopic);
     }
 }
 
 void Server::_handleMode(Client* client, const std::vector<std::string>& params) {
-    if (!client->isRegistered()) {
-        _sendNumericReply(client, ERR_NOTREGISTERED, ":You have not registered");
-        return;
-    }
-    
-    if (params.empty()) {
-        _sendNumericReply(client, ERR_NEEDMOREPARAMS, "MODE :Not enough parameters");
-        return;
-    }
-    
     std::string target = params[0];
     
     if (target[0] == '#' || target[0] == '&') {
-        Channel* channel = getChannel(target);
+        Channel* channel = _acquireChannel(target, false);
+        ChannelLock channelLock(channel);
         if (!channel) {
             _sendNumericReply(client, ERR_NOSUCHCHANNEL, target + " :No such channel");
             return;
@@ -633,6 +617,7 @@ void Server::_handleMode(Client* client, const std::vector<std::string>& params)
             } else if (mode == 'o') {
                 if (paramIndex < params.size()) {
                     std::string targetNick = params[paramIndex++];
+                    ReadLock nickLock(_nicknamesLock);
                     Client* targetClient = getClientByNick(targetNick);
                     if (targetClient && channel->hasClient(targetClient)) {
                         if (adding) {
@@ -650,9 +635,9 @@ void Server::_handleMode(Client* client, const std::vector<std::string>& params)
         }
         
         if (!appliedModes.empty() && appliedModes != "+" && appliedModes != "-") {
-            std::string modeMsg = ":" + client->getPrefix() + " MODE " + target + " " + appliedModes + appliedParams;
+            std::string modeMsg = ":" + client->getPrefix() + " MODE " + channel->getName() + " " + appliedModes + appliedParams;
             _sendToChannel(channel, modeMsg);
-            _logMessage("INFO", client->getNickname() + " set mode " + appliedModes + " on " + target);
+            _logMessage(LOG_INFO, client->getNickname() + " set mode " + appliedModes + " on " + target);
         }
     } else {
         _sendNumericReply(client, ERR_USERSDONTMATCH, ":Cannot change mode for other users");
@@ -660,20 +645,11 @@ void Server::_handleMode(Client* client, const std::vector<std::string>& params)
 }
 
 void Server::_handleWho(Client* client, const std::vector<std::string>& params) {
-    if (!client->isRegistered()) {
-        _sendNumericReply(client, ERR_NOTREGISTERED, ":You have not registered");
-        return;
-    }
-    
-    if (params.empty()) {
-        _sendNumericReply(client, ERR_NEEDMOREPARAMS, "WHO :Not enough parameters");
-        return;
-    }
-    
     std::string mask = params[0];
     
     if (mask[0] == '#' || mask[0] == '&') {
-        Channel* channel = getChannel(mask);
+        Channel* channel = _acquireChannel(mask, false);
+        ChannelLock channelLock(channel);
         if (!channel) {
             _sendNumericReply(client, ERR_NOSUCHCHANNEL, mask + " :No such channel");
             return;
@@ -684,8 +660,9 @@ void Server::_handleWho(Client* client, const std::vector<std::string>& params)
             return;
         }
         
-        const std::set<Client*>& clients = channel->getClients();
-        for (std::set<Client*>::const_iterator it = clients.begin(); it != clients.end(); ++it) {
+        ReadLock nickLock(_nicknamesLock);
+        const ClientSet& clients = channel->getClients();
+        for (ClientSet::const_iterator it = clients.begin(); it != clients.end(); ++it) {
             _sendWhoReply(client, channel, *it);
         }
     }
@@ -694,39 +671,28 @@ void Server::_handleWho(Client* client, const std::vector<std::string>& params)
 }
 
 void Server::_handleWhois(Client* client, const std::vector<std::string>& params) {
-    if (!client->isRegistered()) {
-        _sendNumericReply(client, ERR_NOTREGISTERED, ":You have not registered");
-        return;
-    }
-    
-    if (params.empty()) {
-        _sendNumericReply(client, ERR_NEEDMOREPARAMS, "WHOIS :Not enough parameters");
-        return;
-    }
-    
     std::string targetNick = params[0];
-    Client* targetClient = getClientByNick(targetNick);
     
-    if (!targetClient) {
+    if (!_sendWhoisReply(client, targetNick)) {
         _sendNumericReply(client, ERR_NOSUCHNICK, targetNick + " :No such nick");
         return;
     }
     
-    _sendWhoisReply(client, targetClient);
     _sendNumericReply(client, RPL_ENDOFWHOIS, targetNick + " :End of /WHOIS list");
 }
 
 void Server::_handleList(Client* client, const std::vector<std::string>& params) {
-    if (!client->isRegistered()) {
-        _sendNumericReply(client, ERR_NOTREGISTERED, ":You have not registered");
-        return;
-    }
-    
     _sendNumericReply(client, RPL_LISTSTART, "Channel :Users  Name");
     
     if (params.empty()) {
-        for (std::map<std::string, Channel*>::iterator it = _channels.begin(); it != _channels.end(); ++it) {
-            _sendListReply(client, it->second);
+        std::vector<Channel*> channels;
+        _retainChannels(channels);
+        for (size_t i = 0; i < channels.size(); i++) {
+            channels[i]->lock();
+            ChannelLock channelLock(channels[i]);
+            if (!channels[i]->isRemoved()) {
+                _sendListReply(client, channels[i]);
+            }
         }
     } else {
         std::string channelList = params[0];
@@ -735,7 +701,8 @@ void Server::_handleList(Client* client, const std::vector<std::string>& params)
         
         while (std::getline(channelStream, channelName, ',')) {
             if (!channelName.empty()) {
-                Channel* channel = getChannel(channelName);
+                Channel* channel = _acquireChannel(channelName, false);
+                ChannelLock channelLock(channel);
                 if (channel) {
                     _sendListReply(client, channel);
                 }
@@ -747,15 +714,16 @@ void Server::_handleList(Client* client, const std::vector<std::string>& params)
 }
 
 void Server::_handleNames(Client* client, const std::vector<std::string>& params) {
-    if (!client->isRegistered()) {
-        _sendNumericReply(client, ERR_NOTREGISTERED, ":You have not registered");
-        return;
-    }
-    
     if (params.empty()) {
-        for (std::map<std::string, Channel*>::iterator it = _channels.begin(); it != _channels.end(); ++it) {
-            _sendNumericReply(client, RPL_NAMREPLY, "= " + it->first + " :" + it->second->getNamesReply());
-            _sendNumericReply(client, RPL_ENDOFNAMES, it->first + " :End of /NAMES list");
+        std::vector<Channel*> channels;
+        _retainChannels(channels);
+        for (size_t i = 0; i < channels.size(); i++) {
+            Channel* channel = channels[i];
+            channel->lock();
+            ChannelLock channelLock(channel);
+            if (channel->isRemoved()) continue;
+            _sendNumericReply(client, RPL_NAMREPLY, "= " + channel->getName() + " :" + _getNamesReply(channel));
+            _sendNumericReply(client, RPL_ENDOFNAMES, channel->getName() + " :End of /NAMES list");
         }
     } else {
         std::string channelList = params[0];
@@ -764,9 +732,10 @@ void Server::_handleNames(Client* client, const std::vector<std::string>& params
         
         while (std::getline(channelStream, channelName, ',')) {
             if (!channelName.empty()) {
-                Channel* channel = getChannel(channelName);
+                Channel* channel = _acquireChannel(channelName, false);
+                ChannelLock channelLock(channel);
                 if (channel) {
-                    _sendNumericReply(client, RPL_NAMREPLY, "= " + channelName + " :" + channel->getNamesReply());
+                    _sendNumericReply(client, RPL_NAMREPLY, "= " + channelName + " :" + _getNamesReply(channel));
                     _sendNumericReply(client, RPL_ENDOFNAMES, channelName + " :End of /NAMES list");
                 }
             }
@@ -776,21 +745,11 @@ void Server::_handleNames(Client* client, const std::vector<std::string>& params
 
 void Server::_handleMotd(Client* client, const std::vector<std::string>& params) {
     (void)params;
-    if (!client->isRegistered()) {
-        _sendNumericReply(client, ERR_NOTREGISTERED, ":You have not registered");
-        return;
-    }
-    
     _sendMotd(client);
 }
 
 void Server::_handleAdmin(Client* client, const std::vector<std::string>& params) {
     (void)params;
-    if (!client->isRegistered()) {
-        _sendNumericReply(client, ERR_NOTREGISTERED, ":You have not registered");
-        return;
-    }
-    
     _sendNumericReply(client, 256, ":Administrative info about " + _serverName);
     _sendNumericReply(client, 257, ":42 School IRC Server");
     _sendNumericReply(client, 258, ":ft_irc project implementation");
@@ -799,11 +758,6 @@ void Server::_handleAdmin(Client* client, const std::vector<std::string>& params
 
 void Server::_handleTime(Client* client, const std::vector<std::string>& params) {
     (void)params;
-    if (!client->isRegistered()) {
-        _sendNumericReply(client, ERR_NOTREGISTERED, ":You have not registered");
-        return;
-    }
-    
     time_t now;
     time(&now);
     std::string timeStr = ctime(&now);
@@ -816,21 +770,11 @@ void Server::_handleTime(Client* client, const std::vector<std::string>& params)
 
 void Server::_handleVersion(Client* client, const std::vector<std::string>& params) {
     (void)params;
-    if (!client->isRegistered()) {
-        _sendNumericReply(client, ERR_NOTREGISTERED, ":You have not registered");
-        return;
-    }
-    
     _sendNumericReply(client, RPL_VERSION, _serverVersion + "." + _serverName + " :ft_irc server");
 }
 
 void Server::_handleInfo(Client* client, const std::vector<std::string>& params) {
     (void)params;
-    if (!client->isRegistered()) {
-        _sendNumericReply(client, ERR_NOTREGISTERED, ":You have not registered");
-        return;
-    }
-    
     _sendNumericReply(client, RPL_INFO, ":ft_irc - Internet Relay Chat Server");
     _sendNumericReply(client, RPL_INFO, ":Version " + _serverVersion);
     _sendNumericReply(client, RPL_INFO, ":Created by 42 School students");
@@ -841,12 +785,18 @@ void Server::_handleInfo(Client* client, const std::vector<std::string>& params)
 }
 
 void Server::_handleStats(Client* client, const std::vector<std::string>& params) {
-    (void)params;
-    if (!client->isRegistered()) {
-        _sendNumericReply(client, ERR_NOTREGISTERED, ":You have not registered");
+    if (!params.empty() && (params[0] == "l" || params[0] == "L")) {
+        _sendStatsLinkInfo(client);
+        return;
+    }
+    if (!params.empty() && (params[0] == "m" || params[0] == "M")) {
+        if (!client->isOperator()) {
+            _sendNumericReply(client, ERR_NOPRIVILEGES, ":Permission Denied- You're not an IRC operator");
+            return;
+        }
+        _sendStatsCommands(client);
         return;
     }
-    
     _sendStatsReply(client);
 }
 
@@ -864,26 +814,49 @@ void Server::_sendWhoReply(Client* client, Channel* channel, Client* target) {
     _sendNumericReply(client, RPL_WHOREPLY, oss.str());
 }
 
-void Server::_sendWhoisReply(Client* client, Client* target) {
-    _sendNumericReply(client, RPL_WHOISUSER, target->getNickname() + " " + 
-                     target->getUsername() + " " + target->getHostname() + " * :" + target->getRealname());
+bool Server::_sendWhoisReply(Client* client, const std::string& nickname) {
+    Client* target;
+    std::string targetNick;
+    unsigned long long targetId;
+    std::vector<Channel*> targetChannels;
+    
+    {
+        ReadLock lock(_nicknamesLock);
+        target = getClientByNick(nickname);
+        if (!target) return false;
+        
+        targetNick = target->getNickname();
+        targetId = target->getId();
+        target->collectChannels(targetChannels);
+        
+        _sendNumericReply(client, RPL_WHOISUSER, targetNick + " " + 
+                         target->getUsername() + " " + target->getHostname() + " * :" + target->getRealname());
+    }
     
-    _sendNumericReply(client, RPL_WHOISSERVER, target->getNickname() + " " + 
+    _sendNumericReply(client, RPL_WHOISSERVER, targetNick + " " + 
                      _serverName + " :" + _serverName + " IRC Server");
     
-    if (!target->getChannels().empty()) {
-        std::string channels;
-        const std::set<Channel*>& clientChannels = target->getChannels();
-        for (std::set<Channel*>::const_iterator it = clientChannels.begin(); it != clientChannels.end(); ++it) {
-            if (!channels.empty()) channels += " ";
-            if ((*it)->isOperator(target)) channels += "@";
-            channels += (*it)->getName();
+    std::string channels;
+    for (size_t i = 0; i < targetChannels.size(); i++) {
+        Channel* channel = targetChannels[i];
+        channel->lock();
+        ChannelLock channelLock(channel);
+        ReadLock lock(_nicknamesLock);
+        
+        if (getClientByNick(targetNick) != target || target->getId() != targetId || !channel->hasClient(target)) {
+            continue;
         }
-        _sendNumericReply(client, RPL_WHOISCHANNELS, target->getNickname() + " :" + channels);
+        if (!channels.empty()) channels += " ";
+        if (channel->isOperator(target)) channels += "@";
+        channels += channel->getName();
+    }
+    if (!channels.empty()) {
+        _sendNumericReply(client, RPL_WHOISCHANNELS, targetNick + " :" + channels);
     }
     
-    _sendNumericReply(client, RPL_WHOISIDLE, target->getNickname() + " 0 " + 
+    _sendNumericReply(client, RPL_WHOISIDLE, targetNick + " 0 " + 
                      intToString(_startTime) + " :seconds idle, signon time");
+    return true;
 }
 
 void Server::_sendListReply(Client* client, Channel* channel) {
@@ -898,9 +871,70 @@ void Server::_sendListReply(Client* client, Channel* channel) {
 
 void Server::_sendStatsReply(Client* client) {
     _sendNumericReply(client, 242, ":Server Up " + _getUptime());
-    _sendNumericReply(client, 243, ":Total connections: " + sizeToString(_totalConnections));
-    _sendNumericReply(client, 244, ":Current connections: " + sizeToString(_currentConnections));
+    _sendNumericReply(client, 243, ":Total connections: " + sizeToString(getTotalConnections()));
+    _sendNumericReply(client, 244, ":Current connections: " + sizeToString(getCurrentConnections()));
     _sendNumericReply(client, 245, ":Maximum connections: " + sizeToString(_maxClients));
-    _sendNumericReply(client, 246, ":Active channels: " + sizeToString(_channels.size()));
+    _sendNumericReply(client, 246, ":Active channels: " + sizeToString(_getChannelCount()));
     _sendNumericReply(client, 219, "u :End of /STATS report");
+}
+
+void Server::_sendStatsLinkInfo(Client* client) {
+    if (!client->isOperator()) {
+        _sendLinkInfoLine(client, client);
+    } else {
+        for (size_t i = 0; i < _reactors.size(); i++) {
+            MutexLock lock(_reactors[i]->getClientsMutex());
+            ReadLock nickLock(_nicknamesLock);
+            const ClientTable& clients = _reactors[i]->getClients();
+            for (ClientTable::const_iterator it = clients.begin(); it != clients.end(); ++it) {
+                _sendLinkInfoLine(client, *it);
+            }
+        }
+    }
+    _sendNumericReply(client, 219, "l :End of /STATS report");
+}
+
+void Server::_sendLinkInfoLine(Client* client, Client* target) {
+    std::string nick = target->getNickname().empty() ? "*" : target->getNickname();
+    
+    std::ostringstream oss;
+    oss << nick << "[" << target->getUsername() << "@" << target->getHostname() << "] "
+        << target->getSendQueueBytes() << " "
+        << target->getMessagesSent() << " " << target->getBytesSent() / 1024 << " "
+        << target->getMessageCount() << " " << target->getBytesReceived() / 1024 << " "
+        << ":" << (time(NULL) - target->getConnectTime());
+    _sendNumericReply(client, 211, oss.str());
+}
+
+void Server::_collectCommandTimes(size_t command, Histogram& total) const {
+    for (size_t i = 0; i < _reactors.size(); i++) {
+        total.merge(_reactors[i]->getCommandTimes()[command]);
+    }
+}
+
+void Server::_sendStatsCommands(Client* client) {
+    for (size_t i = 0; i < _commandCount; i++) {
+        Histogram times;
+        _collectCommandTimes(i, times);
+        if (times.getCount() == 0) continue;
+        
+        std::ostringstream oss;
+        oss << _commandTable[i].name << " " << times.getCount()
+            << " :avg " << times.getMean() / 1000 << "us p50 " << times.getPercentile(0.50) / 1000
+            << "us p99 " << times.getPercentile(0.99) / 1000 << "us p999 " << times.getPercentile(0.999) / 1000
+            << "us max " << times.getMax() / 1000 << "us";
+        _sendNumericReply(client, 212, oss.str());
+    }
+    
+    for (size_t i = 0; i < _reactors.size(); i++) {
+        const Histogram& times = _reactors[i]->getLoopTimes();
+        
+        std::ostringstream oss;
+        oss << "m :loop reactor " << i << " iterations " << times.getCount()
+            << " avg " << times.getMean() / 1000 << "us p50 " << times.getPercentile(0.50) / 1000
+            << "us p99 " << times.getPercentile(0.99) / 1000 << "us p999 " << times.getPercentile(0.999) / 1000
+            << "us max " << times.getMax() / 1000 << "us";
+        _sendNumericReply(client, 249, oss.str());
+    }
+    _sendNumericReply(client, 219, "m :End of /STATS report");
 }
\ No newline at end of file
@@ -0,0 +1,251 @@
+#include "Server.hpp"
+#include "Client.hpp"
+#include "Channel.hpp"
+
+extern std::string sizeToString(size_t value);
+
+static std::string buildHttpResponse(const std::string& status, const std::string& headers, const std::string& body, bool includeBody) {
+    std::ostringstream oss;
+    oss << "HTTP/1.1 " << status << "\r\n"
+        << headers
+        << "Content-Length: " << body.length() << "\r\n"
+        << "Connection: close\r\n\r\n";
+    if (includeBody) {
+        oss << body;
+    }
+    return oss.str();
+}
+
+static void writeMetricHeader(std::ostringstream& oss, const char* name, const char* type, const char* help) {
+    oss << "# HELP " << name << " " << help << "\n"
+        << "# TYPE " << name << " " << type << "\n";
+}
+
+static void writeSummary(std::ostringstream& oss, const char* name, const std::string& labels, const Histogram& histogram) {
+    static const double quantiles[] = { 0.5, 0.9, 0.99, 0.999 };
+    
+    for (size_t i = 0; i < sizeof(quantiles) / sizeof(quantiles[0]); i++) {
+        oss << name << "{" << labels << ",quantile=\"" << quantiles[i] << "\"} "
+            << histogram.getPercentile(quantiles[i]) / 1e9 << "\n";
+    }
+    oss << name << "_sum{" << labels << "} " << histogram.getSum() / 1e9 << "\n"
+        << name << "_count{" << labels << "} " << histogram.getCount() << "\n";
+}
+
+void Server::_setupMetricsSocket() {
+    _metricsFd = _createListenSocket(_metricsPort, INADDR_LOOPBACK, false);
+    if (!_reactors[0]->getPoller()->add(_metricsFd, POLLIN)) {
+        throw std::runtime_error("Failed to register metrics socket: " + std::string(strerror(errno)));
+    }
+}
+
+bool Server::_isMetricsConnection(Reactor* reactor, int fd) const {
+    if (reactor->getIndex() != 0 || _metricsConnections.empty()) {
+        return false;
+    }
+    return _metricsConnections.find(fd) != _metricsConnections.end();
+}
+
+void Server::_acceptMetricsClients() {
+    while (true) {
+#ifdef __linux__
+        int fd = accept4(_metricsFd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+#else
+        int fd = accept(_metricsFd, NULL, NULL);
+#endif
+        if (fd == -1) {
+            if (errno != EWOULDBLOCK && errno != EAGAIN) {
+                _logMessage(LOG_WARNING, "Failed to accept metrics connection: " + std::string(strerror(errno)));
+            }
+            return;
+        }
+        
+        if (_metricsConnections.size() >= METRICS_MAX_CONNECTIONS) {
+            close(fd);
+            continue;
+        }
+    
+#ifndef __linux__
+        if (fcntl(fd, F_SETFL, O_NONBLOCK) == -1) {
+            _logMessage(LOG_WARNING, "Failed to set metrics connection non-blocking: " + std::string(strerror(errno)));
+            close(fd);
+            continue;
+        }
+#endif
+        
+        if (!_reactors[0]->getPoller()->add(fd, POLLIN)) {
+            _logMessage(LOG_WARNING, "Failed to register metrics connection: " + std::string(strerror(errno)));
+            close(fd);
+            continue;
+        }
+        
+        MetricsConnection& connection = _metricsConnections[fd];
+        connection.openedAt = monotonicSeconds();
+    }
+}
+
+void Server::_handleMetricsEvent(int fd, short revents) {
+    MetricsConnection& connection = _metricsConnections[fd];
+    
+    if ((revents & POLLIN) && connection.output.empty()) {
+        char buffer[2048];
+        ssize_t bytesRead;
+        
+        while ((bytesRead = recv(fd, buffer, sizeof(buffer), 0)) > 0) {
+            connection.input.append(buffer, static_cast<size_t>(bytesRead));
+            if (connection.input.length() > METRICS_MAX_REQUEST) break;
+        }
+        
+        if (bytesRead == 0 || (bytesRead == -1 && errno != EWOULDBLOCK && errno != EAGAIN)) {
+            _closeMetricsConnection(fd);
+            return;
+        }
+        
+        if (connection.input.length() > METRICS_MAX_REQUEST) {
+            connection.output = buildHttpResponse("431 Request Header Fields Too Large", "", "", false);
+        } else if (connection.input.find("\r\n\r\n") != std::string::npos || connection.input.find("\n\n") != std::string::npos) {
+            connection.output = _buildMetricsResponse(connection.input);
+        } else {
+            return;
+        }
+    }
+    
+    if (connection.output.empty()) {
+        if (revents & (POLLHUP | POLLERR | POLLNVAL)) {
+            _closeMetricsConnection(fd);
+        }
+        return;
+    }
+    
+    while (!connection.output.empty()) {
+        ssize_t sent = send(fd, connection.output.data(), connection.output.length(), 0);
+        if (sent > 0) {
+            connection.output.erase(0, static_cast<size_t>(sent));
+            continue;
+        }
+        if (sent == -1 && errno == EINTR) {
+            continue;
+        }
+        if (sent == -1 && (errno == EWOULDBLOCK || errno == EAGAIN)) {
+            _reactors[0]->getPoller()->modify(fd, POLLOUT);
+            return;
+        }
+        break;
+    }
+    _closeMetricsConnection(fd);
+}
+
+void Server::_closeMetricsConnection(int fd) {
+    _reactors[0]->getPoller()->remove(fd);
+    close(fd);
+    _metricsConnections.erase(fd);
+}
+
+void Server::_expireMetricsConnections(Reactor* reactor) {
+    if (reactor->getIndex() != 0 || _metricsConnections.empty()) return;
+    
+    double now = monotonicSeconds();
+    std::vector<int> expired;
+    for (std::map<int, MetricsConnection>::const_iterator it = _metricsConnections.begin(); it != _metricsConnections.end(); ++it) {
+        if (now - it->second.openedAt > METRICS_TIMEOUT) {
+            expired.push_back(it->first);
+        }
+    }
+    for (size_t i = 0; i < expired.size(); i++) {
+        _closeMetricsConnection(expired[i]);
+    }
+}
+
+std::string Server::_buildMetricsResponse(const std::string& request) {
+    std::istringstream requestLine(request.substr(0, request.find('\n')));
+    std::string method;
+    std::string target;
+    requestLine >> method >> target;
+    
+    std::string path = target.substr(0, target.find('?'));
+    if (path != "/metrics") {
+        return buildHttpResponse("404 Not Found", "Content-Type: text/plain\r\n", "Not Found\n", method != "HEAD");
+    }
+    if (method != "GET" && method != "HEAD") {
+        return buildHttpResponse("405 Method Not Allowed", "Allow: GET, HEAD\r\nContent-Type: text/plain\r\n", "Method Not Allowed\n", true);
+    }
+    
+    return buildHttpResponse("200 OK", "Content-Type: text/plain; version=0.0.4; charset=utf-8\r\n", _renderMetrics(), method == "GET");
+}
+
+std::string Server::_renderMetrics() {
+    size_t registered = 0;
+    unsigned long long sendQueueBytes = 0;
+    size_t largestSendQueue = 0;
+    for (size_t i = 0; i < _reactors.size(); i++) {
+        MutexLock lock(_reactors[i]->getClientsMutex());
+        const ClientTable& clients = _reactors[i]->getClients();
+        for (ClientTable::const_iterator it = clients.begin(); it != clients.end(); ++it) {
+            Client* client = *it;
+            size_t queued = client->getSendQueueBytes();
+            if (client->isRegistered()) registered++;
+            sendQueueBytes += queued;
+            if (queued > largestSendQueue) largestSendQueue = queued;
+        }
+    }
+    
+    std::ostringstream oss;
+    
+    writeMetricHeader(oss, "ircserv_uptime_seconds", "gauge", "Seconds since the server started.");
+    oss << "ircserv_uptime_seconds " << static_cast<long>(difftime(time(NULL), _startTime)) << "\n";
+    
+    writeMetricHeader(oss, "ircserv_connections", "gauge", "Client connections currently open.");
+    oss << "ircserv_connections " << getCurrentConnections() << "\n";
+    
+    writeMetricHeader(oss, "ircserv_connections_total", "counter", "Client connections accepted since start.");
+    oss << "ircserv_connections_total " << getTotalConnections() << "\n";
+    
+    writeMetricHeader(oss, "ircserv_registered_clients", "gauge", "Clients that completed registration.");
+    oss << "ircserv_registered_clients " << registered << "\n";
+    
+    writeMetricHeader(oss, "ircserv_channels", "gauge", "Channels currently in existence.");
+    oss << "ircserv_channels " << _getChannelCount() << "\n";
+    
+    writeMetricHeader(oss, "ircserv_received_bytes_total", "counter", "Bytes read from client sockets.");
+    oss << "ircserv_received_bytes_total " << __atomic_load_n(&_bytesReceived, __ATOMIC_RELAXED) << "\n";
+    
+    writeMetricHeader(oss, "ircserv_sent_bytes_total", "counter", "Bytes written to client sockets.");
+    oss << "ircserv_sent_bytes_total " << __atomic_load_n(&_bytesSent, __ATOMIC_RELAXED) << "\n";
+    
+    writeMetricHeader(oss, "ircserv_sendq_bytes", "gauge", "Bytes queued for delivery across all clients.");
+    oss << "ircserv_sendq_bytes " << sendQueueBytes << "\n";
+    
+    writeMetricHeader(oss, "ircserv_sendq_max_bytes", "gauge", "Largest send queue held by a single client.");
+    oss << "ircserv_sendq_max_bytes " << largestSendQueue << "\n";
+    
+    writeMetricHeader(oss, "ircserv_dropped_writes_total", "counter", "Outgoing messages discarded by send queue overflow or write errors.");
+    oss << "ircserv_dropped_writes_total " << __atomic_load_n(&_droppedWrites, __ATOMIC_RELAXED) << "\n";
+    
+    writeMetricHeader(oss, "ircserv_dropped_deliveries_total", "counter", "Messages discarded because the owning reactor's inbox was full, by reactor.");
+    for (size_t i = 0; i < _reactors.size(); i++) {
+        oss << "ircserv_dropped_deliveries_total{reactor=\"" << i << "\"} " << _reactors[i]->getDroppedDeliveries() << "\n";
+    }
+    
+    std::vector<Histogram> commandTimes(_commandCount);
+    for (size_t i = 0; i < _commandCount; i++) {
+        _collectCommandTimes(i, commandTimes[i]);
+    }
+    
+    writeMetricHeader(oss, "ircserv_commands_total", "counter", "Commands dispatched, by command.");
+    for (size_t i = 0; i < _commandCount; i++) {
+        oss << "ircserv_commands_total{command=\"" << _commandTable[i].name << "\"} " << commandTimes[i].getCount() << "\n";
+    }
+    
+    writeMetricHeader(oss, "ircserv_command_duration_seconds", "summary", "Time spent handling a command, by command.");
+    for (size_t i = 0; i < _commandCount; i++) {
+        if (commandTimes[i].getCount() == 0) continue;
+        writeSummary(oss, "ircserv_command_duration_seconds", std::string("command=\"") + _commandTable[i].name + "\"", commandTimes[i]);
+    }
+    
+    writeMetricHeader(oss, "ircserv_loop_duration_seconds", "summary", "Busy time of each event loop iteration, by reactor.");
+    for (size_t i = 0; i < _reactors.size(); i++) {
+        writeSummary(oss, "ircserv_loop_duration_seconds", "reactor=\"" + sizeToString(i) + "\"", _reactors[i]->getLoopTimes());
+    }
+    
+    return oss.str();
+}
@@ -0,0 +1,81 @@
+#include "SlabPool.hpp"
+
+SlabPool::SlabPool(size_t objectSize, size_t slotsPerSlab, bool shared)
+    : _shared(shared), _freeList(NULL), _slotSize(objectSize), _slotsPerSlab(slotsPerSlab), _inUse(0) {
+    
+    const size_t alignment = 2 * sizeof(void*);
+    if (_slotSize < sizeof(FreeSlot)) {
+        _slotSize = sizeof(FreeSlot);
+    }
+    _slotSize = (_slotSize + alignment - 1) & ~(alignment - 1);
+    if (_slotsPerSlab == 0) {
+        _slotsPerSlab = 1;
+    }
+}
+
+SlabPool::~SlabPool() {
+    for (size_t i = 0; i < _slabs.size(); i++) {
+        delete[] _slabs[i];
+    }
+}
+
+void SlabPool::_grow() {
+    _slabs.reserve(_slabs.size() + 1);
+    char* slab = new char[_slotSize * _slotsPerSlab];
+    _slabs.push_back(slab);
+    
+    for (size_t i = _slotsPerSlab; i > 0; i--) {
+        FreeSlot* slot = reinterpret_cast<FreeSlot*>(slab + (i - 1) * _slotSize);
+        slot->next = _freeList;
+        _freeList = slot;
+    }
+}
+
+size_t SlabPool::getInUse() {
+    MutexLock lock(_mutex);
+    return _inUse;
+}
+
+size_t SlabPool::getCapacity() {
+    MutexLock lock(_mutex);
+    return _slabs.size() * _slotsPerSlab;
+}
+
+void* SlabPool::_take() {
+    if (!_freeList) {
+        _grow();
+    }
+    
+    FreeSlot* slot = _freeList;
+    _freeList = slot->next;
+    _inUse++;
+    return slot;
+}
+
+void SlabPool::_give(void* ptr) {
+    FreeSlot* slot = static_cast<FreeSlot*>(ptr);
+    slot->next = _freeList;
+    _freeList = slot;
+    _inUse--;
+}
+
+void* SlabPool::allocate() {
+    if (!_shared) {
+        return _take();
+    }
+    
+    MutexLock lock(_mutex);
+    return _take();
+}
+
+void SlabPool::release(void* ptr) {
+    if (!ptr) return;
+    
+    if (!_shared) {
+        _give(ptr);
+        return;
+    }
+    
+    MutexLock lock(_mutex);
+    _give(ptr);
+}
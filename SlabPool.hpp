@@ -0,0 +1,43 @@
+#ifndef SLABPOOL_HPP
+#define SLABPOOL_HPP
+
+#include <vector>
+#include <cstddef>
+#include <new>
+
+#include "Mutex.hpp"
+
+class SlabPool {
+private:
+    struct FreeSlot {
+        FreeSlot* next;
+    };
+    
+    Mutex _mutex;
+    bool _shared;
+    std::vector<char*> _slabs;
+    FreeSlot* _freeList;
+    size_t _slotSize;
+    size_t _slotsPerSlab;
+    size_t _inUse;
+    
+    void _grow();
+    void* _take();
+    void _give(void* ptr);
+    
+    SlabPool(const SlabPool&);
+    SlabPool& operator=(const SlabPool&);
+    
+public:
+    SlabPool(size_t objectSize, size_t slotsPerSlab, bool shared = true);
+    ~SlabPool();
+    
+    size_t getSlotSize() const { return _slotSize; }
+    size_t getInUse();
+    size_t getCapacity();
+    
+    void* allocate();
+    void release(void* ptr);
+};
+
+#endif
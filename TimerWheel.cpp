@@ -0,0 +1,83 @@
+#include "TimerWheel.hpp"
+
+TimerWheel::TimerWheel(unsigned long long now) : _current(now), _size(0) {
+    for (unsigned int i = 0; i < LEVELS * SLOTS; i++) {
+        _slots[i].prev = &_slots[i];
+        _slots[i].next = &_slots[i];
+    }
+}
+
+void TimerWheel::schedule(TimerNode* node, unsigned long long expires) {
+    if (node->isScheduled()) {
+        _unlink(node);
+        _size--;
+    }
+    
+    node->expires = expires > _current ? expires : _current + 1;
+    _insert(node);
+    _size++;
+}
+
+void TimerWheel::cancel(TimerNode* node) {
+    if (node->isScheduled()) {
+        _unlink(node);
+        _size--;
+    }
+}
+
+void TimerWheel::advance(unsigned long long now, std::vector<TimerNode*>& expired) {
+    expired.clear();
+    
+    while (_current < now) {
+        _current++;
+        
+        for (unsigned int level = 1; level < LEVELS; level++) {
+            if (_current & ((1ULL << (SLOT_BITS * level)) - 1)) break;
+            _cascade(level);
+        }
+        
+        TimerNode* head = &_slots[_current & SLOT_MASK];
+        while (head->next != head) {
+            TimerNode* node = head->next;
+            _unlink(node);
+            _size--;
+            expired.push_back(node);
+        }
+    }
+}
+
+void TimerWheel::_insert(TimerNode* node) {
+    unsigned long long delta = node->expires - _current;
+    unsigned int level = 0;
+    
+    while (level < LEVELS - 1 && delta >= (1ULL << (SLOT_BITS * (level + 1)))) {
+        level++;
+    }
+    
+    if (delta >= (1ULL << (SLOT_BITS * LEVELS))) {
+        node->expires = _current + (1ULL << (SLOT_BITS * LEVELS)) - 1;
+    }
+    
+    TimerNode* head = &_slots[level * SLOTS + ((node->expires >> (SLOT_BITS * level)) & SLOT_MASK)];
+    node->prev = head->prev;
+    node->next = head;
+    head->prev->next = node;
+    head->prev = node;
+}
+
+void TimerWheel::_unlink(TimerNode* node) {
+    node->prev->next = node->next;
+    node->next->prev = node->prev;
+    node->prev = NULL;
+    node->next = NULL;
+}
+
+void TimerWheel::_cascade(unsigned int level) {
+    TimerNode* head = &_slots[level * SLOTS + ((_current >> (SLOT_BITS * level)) & SLOT_MASK)];
+    
+    while (head->next != head) {
+        TimerNode* node = head->next;
+        _unlink(node);
+        _insert(node);
+    }
+}
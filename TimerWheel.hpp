@@ -0,0 +1,48 @@
+#ifndef TIMERWHEEL_HPP
+#define TIMERWHEEL_HPP
+
+#include <vector>
+#include <cstddef>
+
+struct TimerNode {
+    TimerNode* prev;
+    TimerNode* next;
+    unsigned long long expires;
+    void* owner;
+    
+    TimerNode() : prev(NULL), next(NULL), expires(0), owner(NULL) {}
+    
+    bool isScheduled() const { return next != NULL; }
+};
+
+class TimerWheel {
+private:
+    static const unsigned int LEVELS = 4;
+    static const unsigned int SLOT_BITS = 6;
+    static const unsigned int SLOTS = 1 << SLOT_BITS;
+    static const unsigned int SLOT_MASK = SLOTS - 1;
+    
+    TimerNode _slots[LEVELS * SLOTS];
+    unsigned long long _current;
+    size_t _size;
+    
+    void _insert(TimerNode* node);
+    void _unlink(TimerNode* node);
+    void _cascade(unsigned int level);
+    
+    TimerWheel(const TimerWheel&);
+    TimerWheel& operator=(const TimerWheel&);
+    
+public:
+    explicit TimerWheel(unsigned long long now);
+    
+    unsigned long long getCurrent() const { return _current; }
+    size_t size() const { return _size; }
+    bool empty() const { return _size == 0; }
+    
+    void schedule(TimerNode* node, unsigned long long expires);
+    void cancel(TimerNode* node);
+    void advance(unsigned long long now, std::vector<TimerNode*>& expired);
+};
+
+#endif
@@ -0,0 +1,497 @@
+#include "LoadGenerator.hpp"
+#include "../Clock.hpp"
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+
+LoadConfig::LoadConfig()
+    : host("127.0.0.1"), port(6667), backend("epoll"), clients(100), channels(10), channelsPerClient(1),
+      messageSize(64), rate(1000), duration(10), interval(1), setupTimeout(30), serverPid(0) {}
+
+LoadGenerator::LoadGenerator(const LoadConfig& config)
+    : _config(config), _poller(NULL), _registered(0), _joined(0), _lost(0), _nextSender(0), _start(0), _lastReport(0),
+      _sent(0), _expected(0), _delivered(0), _peakRss(-1) {
+    
+    if (_config.channelsPerClient > _config.channels) {
+        _config.channelsPerClient = _config.channels;
+    }
+    
+    _interval.sent = 0;
+    _interval.delivered = 0;
+    _poller = Poller::create(_config.backend);
+}
+
+LoadGenerator::~LoadGenerator() {
+    for (size_t i = 0; i < _clients.size(); i++) {
+        if (_clients[i].connected) {
+            close(_clients[i].fd);
+        }
+    }
+    delete _poller;
+}
+
+void LoadGenerator::run() {
+    std::cout << "Connecting " << _config.clients << " clients to " << _config.host << ":" << _config.port
+              << " (" << _config.channels << " channels, " << _config.channelsPerClient << " per client, "
+              << _config.rate << " msg/s for " << _config.duration << "s, backend " << _poller->getName() << ")" << std::endl;
+    
+    double setupStart = monotonicSeconds();
+    _connectAll();
+    _registerAll();
+    _joinAll();
+    std::cout << "Setup complete in " << std::fixed << std::setprecision(2) << monotonicSeconds() - setupStart
+              << "s" << std::endl << std::endl;
+    
+    _printHeader();
+    _drive();
+    _drain();
+    _summary(monotonicSeconds() - _start);
+}
+
+void LoadGenerator::_connectAll() {
+    struct sockaddr_in address;
+    std::memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_port = htons(static_cast<unsigned short>(_config.port));
+    if (inet_pton(AF_INET, _config.host.c_str(), &address.sin_addr) != 1) {
+        throw std::runtime_error("Invalid host address: " + _config.host);
+    }
+    
+    _channelMembers.assign(_config.channels, 0);
+    _clients.reserve(_config.clients);
+    
+    for (size_t i = 0; i < _config.clients; i++) {
+        int fd = socket(AF_INET, SOCK_STREAM, 0);
+        if (fd == -1) {
+            throw std::runtime_error("Failed to create socket: " + std::string(strerror(errno)));
+        }
+        
+        if (connect(fd, reinterpret_cast<struct sockaddr*>(&address), sizeof(address)) == -1) {
+            std::string error = strerror(errno);
+            close(fd);
+            throw std::runtime_error("Failed to connect: " + error);
+        }
+        
+        int noDelay = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+        
+        if (!_poller->add(fd, POLLIN)) {
+            close(fd);
+            throw std::runtime_error("Failed to register socket with the poller");
+        }
+        
+        std::ostringstream nickname;
+        nickname << "bn" << i;
+        
+        BenchClient client;
+        client.fd = fd;
+        client.nickname = nickname.str();
+        client.nextChannel = 0;
+        client.pendingJoins = 0;
+        client.registered = false;
+        client.connected = true;
+        client.wantWrite = false;
+        for (size_t j = 0; j < _config.channelsPerClient; j++) {
+            size_t channel = (i + j) % _config.channels;
+            client.channels.push_back(channel);
+            _channelMembers[channel]++;
+        }
+        
+        if (static_cast<size_t>(fd) >= _fdSlots.size()) {
+            _fdSlots.resize(fd + 1, static_cast<size_t>(-1));
+        }
+        _fdSlots[fd] = _clients.size();
+        _clients.push_back(client);
+        
+        BenchClient& added = _clients.back();
+        _queue(added, "PASS " + _config.password);
+        _queue(added, "NICK " + added.nickname);
+        _queue(added, "USER " + added.nickname + " 0 * :ircbench");
+        _flush(added);
+        
+        _poll(0);
+    }
+}
+
+void LoadGenerator::_registerAll() {
+    double deadline = monotonicSeconds() + _config.setupTimeout;
+    while (_registered < _clients.size()) {
+        if (_lost > 0) {
+            throw std::runtime_error("Connection closed by server during registration");
+        }
+        if (monotonicSeconds() > deadline) {
+            std::ostringstream oss;
+            oss << "Timed out waiting for registration (" << _registered << " of " << _clients.size() << ")";
+            throw std::runtime_error(oss.str());
+        }
+        _poll(100);
+    }
+}
+
+void LoadGenerator::_joinAll() {
+    for (size_t i = 0; i < _clients.size(); i++) {
+        BenchClient& client = _clients[i];
+        if (client.channels.empty()) {
+            _joined++;
+            continue;
+        }
+        
+        std::string channels;
+        for (size_t j = 0; j < client.channels.size(); j++) {
+            if (j > 0) channels += ",";
+            channels += _channelName(client.channels[j]);
+        }
+        client.pendingJoins = client.channels.size();
+        _queue(client, "JOIN " + channels);
+        _flush(client);
+    }
+    
+    double deadline = monotonicSeconds() + _config.setupTimeout;
+    while (_joined < _clients.size()) {
+        if (_lost > 0) {
+            throw std::runtime_error("Connection closed by server while joining channels");
+        }
+        if (monotonicSeconds() > deadline) {
+            std::ostringstream oss;
+            oss << "Timed out waiting for channel joins (" << _joined << " of " << _clients.size() << ")";
+            throw std::runtime_error(oss.str());
+        }
+        _poll(100);
+    }
+}
+
+void LoadGenerator::_drive() {
+    _start = monotonicSeconds();
+    _lastReport = _start;
+    double now = _start;
+    
+    while (now - _start < _config.duration) {
+        unsigned long long due = static_cast<unsigned long long>((now - _start) * _config.rate);
+        size_t burst = 0;
+        while (_sent < due && burst < 1024 && _sendNext(now)) {
+            burst++;
+        }
+        
+        int timeoutMs = 0;
+        if (_sent >= due) {
+            double nextSend = static_cast<double>(_sent + 1) / _config.rate - (now - _start);
+            double nextReport = _lastReport + _config.interval - now;
+            double wait = std::min(nextSend, nextReport);
+            timeoutMs = wait > 0 ? static_cast<int>(wait * 1000) + 1 : 0;
+        }
+        _poll(timeoutMs);
+        
+        now = monotonicSeconds();
+        if (now - _lastReport >= _config.interval) {
+            _report(now);
+        }
+    }
+}
+
+void LoadGenerator::_drain() {
+    double deadline = monotonicSeconds() + 5;
+    
+    while (_delivered < _expected && monotonicSeconds() < deadline) {
+        _poll(50);
+        
+        double now = monotonicSeconds();
+        if (now - _lastReport >= _config.interval) {
+            _report(now);
+        }
+    }
+    
+    double now = monotonicSeconds();
+    if (now - _lastReport >= _config.interval / 2) {
+        _report(now);
+    } else {
+        _collect();
+    }
+}
+
+bool LoadGenerator::_poll(int timeoutMs) {
+    int count = _poller->wait(_events, timeoutMs);
+    if (count <= 0) {
+        return false;
+    }
+    
+    for (size_t i = 0; i < _events.size(); i++) {
+        int fd = _events[i].fd;
+        if (fd < 0 || static_cast<size_t>(fd) >= _fdSlots.size() || _fdSlots[fd] == static_cast<size_t>(-1)) {
+            continue;
+        }
+        
+        BenchClient& client = _clients[_fdSlots[fd]];
+        if (_events[i].events & (POLLIN | POLLHUP | POLLERR)) {
+            _readClient(client);
+        }
+        if (client.connected && (_events[i].events & POLLOUT)) {
+            _flush(client);
+        }
+    }
+    return true;
+}
+
+void LoadGenerator::_readClient(BenchClient& client) {
+    char buffer[65536];
+    
+    while (client.connected) {
+        ssize_t bytes = recv(client.fd, buffer, sizeof(buffer), 0);
+        if (bytes > 0) {
+            client.input.append(buffer, bytes);
+            continue;
+        }
+        if (bytes == -1 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            break;
+        }
+        if (bytes == -1 && errno == EINTR) {
+            continue;
+        }
+        _disconnect(client);
+    }
+    
+    size_t start = 0;
+    size_t end;
+    while ((end = client.input.find('\n', start)) != std::string::npos) {
+        size_t length = end - start;
+        if (length > 0 && client.input[end - 1] == '\r') {
+            length--;
+        }
+        _handleLine(client, client.input.substr(start, length));
+        start = end + 1;
+    }
+    client.input.erase(0, start);
+}
+
+void LoadGenerator::_handleLine(BenchClient& client, const std::string& line) {
+    if (line.compare(0, 5, "PING ") == 0) {
+        _queue(client, "PONG " + line.substr(5));
+        _flush(client);
+        return;
+    }
+    
+    if (line.compare(0, 6, "ERROR ") == 0) {
+        if (!client.registered) {
+            throw std::runtime_error("Server refused " + client.nickname + ": " + line);
+        }
+        return;
+    }
+    
+    size_t commandStart = 0;
+    if (!line.empty() && line[0] == ':') {
+        commandStart = line.find(' ');
+        if (commandStart == std::string::npos) return;
+        commandStart++;
+    }
+    
+    size_t commandEnd = line.find(' ', commandStart);
+    if (commandEnd == std::string::npos) return;
+    std::string command = line.substr(commandStart, commandEnd - commandStart);
+    
+    if (command == "PRIVMSG") {
+        size_t trailing = line.find(" :", commandEnd);
+        if (trailing == std::string::npos) return;
+        
+        unsigned long long sentAt = strtoull(line.c_str() + trailing + 2, NULL, 10);
+        unsigned long long now = static_cast<unsigned long long>(monotonicSeconds() * 1e6);
+        unsigned long long latency = now > sentAt ? now - sentAt : 0;
+        _interval.latencies.push_back(latency > 0xFFFFFFFFULL ? 0xFFFFFFFFU : static_cast<unsigned int>(latency));
+        _interval.delivered++;
+        _delivered++;
+    } else if (command == "001") {
+        if (!client.registered) {
+            client.registered = true;
+            _registered++;
+        }
+    } else if (command == "366") {
+        if (client.pendingJoins > 0 && --client.pendingJoins == 0) {
+            _joined++;
+        }
+    } else if (command == "432" || command == "433" || command == "464") {
+        throw std::runtime_error("Registration rejected for " + client.nickname + ": " + line);
+    } else if (command == "405" || command == "471" || command == "473" || command == "474" || command == "475") {
+        throw std::runtime_error("Join rejected for " + client.nickname + ": " + line);
+    }
+}
+
+void LoadGenerator::_queue(BenchClient& client, const std::string& line) {
+    client.output += line;
+    client.output += "\r\n";
+}
+
+void LoadGenerator::_flush(BenchClient& client) {
+    while (client.connected && !client.output.empty()) {
+        ssize_t bytes = send(client.fd, client.output.data(), client.output.size(), MSG_NOSIGNAL);
+        if (bytes > 0) {
+            client.output.erase(0, bytes);
+            continue;
+        }
+        if (bytes == -1 && errno == EINTR) {
+            continue;
+        }
+        if (bytes == -1 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            if (!client.wantWrite) {
+                client.wantWrite = true;
+                _poller->modify(client.fd, POLLIN | POLLOUT);
+            }
+            return;
+        }
+        _disconnect(client);
+        return;
+    }
+    
+    if (client.connected && client.wantWrite) {
+        client.wantWrite = false;
+        _poller->modify(client.fd, POLLIN);
+    }
+}
+
+void LoadGenerator::_disconnect(BenchClient& client) {
+    if (!client.connected) return;
+    
+    _poller->remove(client.fd);
+    close(client.fd);
+    _fdSlots[client.fd] = static_cast<size_t>(-1);
+    client.connected = false;
+    client.output.clear();
+    _lost++;
+}
+
+bool LoadGenerator::_sendNext(double now) {
+    for (size_t attempts = 0; attempts < _clients.size(); attempts++) {
+        BenchClient& client = _clients[_nextSender];
+        _nextSender = (_nextSender + 1) % _clients.size();
+        if (!client.connected || client.channels.empty()) {
+            continue;
+        }
+        
+        size_t channel = client.channels[client.nextChannel];
+        client.nextChannel = (client.nextChannel + 1) % client.channels.size();
+        
+        std::ostringstream oss;
+        oss << "PRIVMSG " << _channelName(channel) << " :" << static_cast<unsigned long long>(now * 1e6) << " ";
+        std::string message = oss.str();
+        if (message.length() < _config.messageSize) {
+            message.append(_config.messageSize - message.length(), 'x');
+        }
+        
+        _queue(client, message);
+        _flush(client);
+        _sent++;
+        _interval.sent++;
+        _expected += _channelMembers[channel] - 1;
+        return true;
+    }
+    return false;
+}
+
+void LoadGenerator::_printHeader() const {
+    std::cout << std::setw(8) << "time(s)" << std::setw(12) << "sent/s" << std::setw(14) << "delivered/s"
+              << std::setw(10) << "p50(us)" << std::setw(10) << "p99(us)" << std::setw(11) << "p999(us)"
+              << std::setw(12) << "rss(KB)" << std::endl;
+}
+
+void LoadGenerator::_report(double now) {
+    double elapsed = now - _start;
+    double span = now - _lastReport;
+    _lastReport = now;
+    
+    unsigned int p50 = 0;
+    unsigned int p99 = 0;
+    unsigned int p999 = 0;
+    _percentiles(_interval.latencies, p50, p99, p999);
+    
+    long rss = _config.serverPid > 0 ? _readRss(_config.serverPid) : -1;
+    if (rss > _peakRss) {
+        _peakRss = rss;
+    }
+    
+    std::cout << std::fixed << std::setprecision(1)
+              << std::setw(8) << elapsed
+              << std::setw(12) << (span > 0 ? _interval.sent / span : 0)
+              << std::setw(14) << (span > 0 ? _interval.delivered / span : 0)
+              << std::setw(10) << p50 << std::setw(10) << p99 << std::setw(11) << p999;
+    if (rss >= 0) {
+        std::cout << std::setw(12) << rss;
+    } else {
+        std::cout << std::setw(12) << "-";
+    }
+    std::cout << std::endl;
+    
+    _collect();
+}
+
+void LoadGenerator::_collect() {
+    _latencies.insert(_latencies.end(), _interval.latencies.begin(), _interval.latencies.end());
+    _interval.latencies.clear();
+    _interval.sent = 0;
+    _interval.delivered = 0;
+}
+
+void LoadGenerator::_summary(double elapsed) {
+    unsigned int p50 = 0;
+    unsigned int p99 = 0;
+    unsigned int p999 = 0;
+    _percentiles(_latencies, p50, p99, p999);
+    unsigned int maximum = _latencies.empty() ? 0 : _latencies.back();
+    
+    double sendSpan = std::min(elapsed, _config.duration);
+    
+    std::cout << std::endl << "Summary:" << std::endl;
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "  Messages sent:      " << _sent << " (" << (sendSpan > 0 ? _sent / sendSpan : 0) << "/s)" << std::endl;
+    std::cout << "  Deliveries:         " << _delivered << " of " << _expected
+              << " (" << (elapsed > 0 ? _delivered / elapsed : 0) << "/s)" << std::endl;
+    std::cout << "  Latency (us):       p50 " << p50 << ", p99 " << p99 << ", p999 " << p999 << ", max " << maximum << std::endl;
+    if (_peakRss >= 0) {
+        std::cout << "  Peak server RSS:    " << _peakRss << " KB" << std::endl;
+    }
+    if (_lost > 0) {
+        std::cout << "  Connections lost:   " << _lost << std::endl;
+    }
+}
+
+std::string LoadGenerator::_channelName(size_t index) {
+    std::ostringstream oss;
+    oss << "#bench" << index;
+    return oss.str();
+}
+
+void LoadGenerator::_percentiles(std::vector<unsigned int>& samples, unsigned int& p50, unsigned int& p99, unsigned int& p999) {
+    if (samples.empty()) {
+        p50 = p99 = p999 = 0;
+        return;
+    }
+    
+    std::sort(samples.begin(), samples.end());
+    size_t last = samples.size() - 1;
+    p50 = samples[std::min(last, static_cast<size_t>(samples.size() * 0.50))];
+    p99 = samples[std::min(last, static_cast<size_t>(samples.size() * 0.99))];
+    p999 = samples[std::min(last, static_cast<size_t>(samples.size() * 0.999))];
+}
+
+long LoadGenerator::_readRss(int pid) {
+    std::ostringstream path;
+    path << "/proc/" << pid << "/status";
+    
+    std::ifstream status(path.str().c_str());
+    std::string line;
+    while (std::getline(status, line)) {
+        if (line.compare(0, 6, "VmRSS:") == 0) {
+            return strtol(line.c_str() + 6, NULL, 10);
+        }
+    }
+    return -1;
+}
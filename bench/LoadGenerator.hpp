@@ -0,0 +1,103 @@
+#ifndef LOADGENERATOR_HPP
+#define LOADGENERATOR_HPP
+
+#include <string>
+#include <vector>
+#include <cstddef>
+
+#include "../Poller.hpp"
+
+struct LoadConfig {
+    std::string host;
+    int port;
+    std::string password;
+    std::string backend;
+    size_t clients;
+    size_t channels;
+    size_t channelsPerClient;
+    size_t messageSize;
+    double rate;
+    double duration;
+    double interval;
+    double setupTimeout;
+    int serverPid;
+    
+    LoadConfig();
+};
+
+class LoadGenerator {
+private:
+    struct BenchClient {
+        int fd;
+        std::string nickname;
+        std::string input;
+        std::string output;
+        std::vector<size_t> channels;
+        size_t nextChannel;
+        size_t pendingJoins;
+        bool registered;
+        bool connected;
+        bool wantWrite;
+    };
+    
+    struct IntervalStats {
+        unsigned long long sent;
+        unsigned long long delivered;
+        std::vector<unsigned int> latencies;
+    };
+    
+    LoadConfig _config;
+    Poller* _poller;
+    std::vector<BenchClient> _clients;
+    std::vector<size_t> _fdSlots;
+    std::vector<size_t> _channelMembers;
+    std::vector<PollerEvent> _events;
+    
+    size_t _registered;
+    size_t _joined;
+    size_t _lost;
+    size_t _nextSender;
+    double _start;
+    double _lastReport;
+    unsigned long long _sent;
+    unsigned long long _expected;
+    unsigned long long _delivered;
+    long _peakRss;
+    
+    IntervalStats _interval;
+    std::vector<unsigned int> _latencies;
+    
+    void _connectAll();
+    void _registerAll();
+    void _joinAll();
+    void _drive();
+    void _drain();
+    
+    bool _poll(int timeoutMs);
+    void _readClient(BenchClient& client);
+    void _handleLine(BenchClient& client, const std::string& line);
+    void _queue(BenchClient& client, const std::string& line);
+    void _flush(BenchClient& client);
+    void _disconnect(BenchClient& client);
+    bool _sendNext(double now);
+    
+    void _printHeader() const;
+    void _report(double now);
+    void _collect();
+    void _summary(double elapsed);
+    
+    static std::string _channelName(size_t index);
+    static void _percentiles(std::vector<unsigned int>& samples, unsigned int& p50, unsigned int& p99, unsigned int& p999);
+    static long _readRss(int pid);
+    
+    LoadGenerator(const LoadGenerator&);
+    LoadGenerator& operator=(const LoadGenerator&);
+    
+public:
+    explicit LoadGenerator(const LoadConfig& config);
+    ~LoadGenerator();
+    
+    void run();
+};
+
+#endif
@@ -0,0 +1,218 @@
+#include "MicroBench.hpp"
+#include "../Server.hpp"
+#include "../Client.hpp"
+#include "../Reactor.hpp"
+#include "../InputBuffer.hpp"
+#include "../Clock.hpp"
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <sys/socket.h>
+
+static unsigned long long allocationCount = 0;
+
+void* operator new(std::size_t size) throw(std::bad_alloc) {
+    allocationCount++;
+    void* ptr = malloc(size ? size : 1);
+    if (!ptr) {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void operator delete(void* ptr) throw() {
+    free(ptr);
+}
+
+unsigned long long MicroBench::getAllocationCount() {
+    return allocationCount;
+}
+
+MicroBench::MicroBench(const std::vector<std::string>& lines, double minTime)
+    : _server(NULL), _reactor(NULL), _client(NULL), _lines(lines), _minTime(minTime), _sink(0) {
+    
+    try {
+        _server = new Server(6667, "");
+        _server->getLogger().setLevel(LOG_ERROR);
+        _server->setFloodRate(0);
+        _reactor = new Reactor(0, _server, "poll");
+        _server->_reactors.push_back(_reactor);
+        _reactor->getCommandTimes().resize(Server::_commandCount);
+        Server::_currentReactor = _reactor;
+        
+        _client = _addClient("bencher");
+        const char* nicknames[] = { "alice", "bob", "carol", "dave", "erin", "frank", "grace", "heidi" };
+        for (size_t i = 0; i < sizeof(nicknames) / sizeof(nicknames[0]); i++) {
+            Client* member = _addClient(nicknames[i]);
+            _members.push_back(member);
+            _dispatch(member, i % 2 ? "JOIN #lobby,#dev" : "JOIN #lobby");
+        }
+        _dispatch(_client, "JOIN #lobby,#dev");
+        _dispatch(_members[1], "TOPIC #dev :release train leaves at 15:00");
+        _discardOutput();
+    } catch (...) {
+        _teardown();
+        throw;
+    }
+    
+    for (size_t i = 0; i < _lines.size(); i++) {
+        _stream += _lines[i];
+        _stream += "\r\n";
+    }
+    
+    _messages.resize(_lines.size());
+    for (size_t i = 0; i < _lines.size(); i++) {
+        _messages[i].parse(_lines[i].data(), _lines[i].length());
+    }
+}
+
+MicroBench::~MicroBench() {
+    _teardown();
+}
+
+void MicroBench::_teardown() {
+    if (_reactor) {
+        _discardOutput();
+    }
+    delete _server;
+    _server = NULL;
+    _reactor = NULL;
+    for (size_t i = 0; i < _peerFds.size(); i++) {
+        close(_peerFds[i]);
+    }
+    _peerFds.clear();
+}
+
+Client* MicroBench::_addClient(const std::string& nickname) {
+    int fds[2];
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == -1) {
+        throw std::runtime_error("Failed to create socket pair: " + std::string(strerror(errno)));
+    }
+    fcntl(fds[0], F_SETFL, O_NONBLOCK);
+    _peerFds.push_back(fds[0]);
+    _peerFds.push_back(fds[1]);
+    
+    Client* client = new (_reactor->getClientPool()) Client(fds[0], _server);
+    client->setHostname("127.0.0.1");
+    client->setId(_peerFds.size() / 2);
+    client->setReactor(0);
+    client->setPasswordProvided(true);
+    client->setNickname(nickname);
+    client->setUsername(nickname);
+    client->setRealname("MicroBench " + nickname);
+    client->tryRegister();
+    
+    _reactor->addClient(fds[0], client);
+    client->setGeneration(_reactor->getClients().getGeneration(fds[0]));
+    _server->_nicknames.insert(client->getFoldedNickname(), client);
+    return client;
+}
+
+void MicroBench::_dispatch(Client* client, const std::string& line) {
+    IrcMessage message;
+    if (message.parse(line.data(), line.length())) {
+        _server->_parseCommand(client, message);
+    }
+}
+
+void MicroBench::_discardOutput() {
+    std::vector<ClientRef>& dirty = _reactor->getDirtyClients();
+    for (size_t i = 0; i < dirty.size(); i++) {
+        Client* client = _reactor->getClients().find(dirty[i].fd, dirty[i].generation);
+        if (!client) continue;
+        client->clearOutput();
+        client->setFlushPending(false);
+        client->setSendQExceeded(false);
+    }
+    dirty.clear();
+    _reactor->getClosingClients().clear();
+}
+
+void MicroBench::_measure(const std::string& name, Pass pass) {
+    (this->*pass)();
+    _discardOutput();
+    
+    unsigned long long ops = 0;
+    unsigned long long allocations = 0;
+    double elapsed = 0;
+    
+    while (elapsed < _minTime) {
+        unsigned long long allocationsBefore = allocationCount;
+        double start = monotonicSeconds();
+        ops += (this->*pass)();
+        elapsed += monotonicSeconds() - start;
+        allocations += allocationCount - allocationsBefore;
+        _discardOutput();
+    }
+    
+    std::cout << std::left << std::setw(12) << name << std::right
+        << std::setw(12) << ops
+        << std::fixed << std::setprecision(1) << std::setw(12) << elapsed * 1e9 / ops
+        << std::setprecision(2) << std::setw(12) << static_cast<double>(allocations) / ops << std::endl;
+}
+
+unsigned long long MicroBench::_framingPass() {
+    InputBuffer input;
+    const char* data = _stream.data();
+    size_t remaining = _stream.length();
+    unsigned long long lines = 0;
+    const char* line;
+    size_t length;
+    
+    while (remaining > 0) {
+        size_t chunk = std::min(std::min(remaining, static_cast<size_t>(1460)), input.getWritableSize());
+        memcpy(input.getWritePtr(), data, chunk);
+        input.commit(chunk);
+        data += chunk;
+        remaining -= chunk;
+        
+        while (input.nextLine(line, length)) {
+            _sink += length;
+            lines++;
+        }
+    }
+    return lines;
+}
+
+unsigned long long MicroBench::_parsePass() {
+    IrcMessage message;
+    for (size_t i = 0; i < _lines.size(); i++) {
+        message.parse(_lines[i].data(), _lines[i].length());
+        _sink += message.getParamCount();
+    }
+    return _lines.size();
+}
+
+unsigned long long MicroBench::_dispatchPass() {
+    for (size_t i = 0; i < _messages.size(); i++) {
+        _server->_parseCommand(_client, _messages[i]);
+    }
+    return _messages.size();
+}
+
+unsigned long long MicroBench::_numericPass() {
+    const size_t count = 64;
+    for (size_t i = 0; i < count; i++) {
+        _server->_sendNumericReply(_client, RPL_TOPIC, "#dev :release train leaves at 15:00");
+    }
+    return count;
+}
+
+unsigned long long MicroBench::_prefixPass() {
+    const size_t count = 256;
+    for (size_t i = 0; i < count; i++) {
+        _sink += _client->getPrefix().length();
+    }
+    return count;
+}
+
+void MicroBench::run() {
+    std::cout << std::left << std::setw(12) << "benchmark" << std::right
+        << std::setw(12) << "ops" << std::setw(12) << "ns/op" << std::setw(12) << "allocs/op" << std::endl;
+    
+    _measure("framing", &MicroBench::_framingPass);
+    _measure("parse", &MicroBench::_parsePass);
+    _measure("dispatch", &MicroBench::_dispatchPass);
+    _measure("numeric", &MicroBench::_numericPass);
+    _measure("prefix", &MicroBench::_prefixPass);
+}
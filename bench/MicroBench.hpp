@@ -0,0 +1,52 @@
+#ifndef MICROBENCH_HPP
+#define MICROBENCH_HPP
+
+#include <string>
+#include <vector>
+
+#include "../IrcMessage.hpp"
+
+class Server;
+class Reactor;
+class Client;
+
+class MicroBench {
+private:
+    typedef unsigned long long (MicroBench::*Pass)();
+    
+    Server* _server;
+    Reactor* _reactor;
+    Client* _client;
+    std::vector<Client*> _members;
+    std::vector<int> _peerFds;
+    std::vector<std::string> _lines;
+    std::string _stream;
+    std::vector<IrcMessage> _messages;
+    double _minTime;
+    volatile size_t _sink;
+    
+    Client* _addClient(const std::string& nickname);
+    void _dispatch(Client* client, const std::string& line);
+    void _discardOutput();
+    void _teardown();
+    void _measure(const std::string& name, Pass pass);
+    
+    unsigned long long _framingPass();
+    unsigned long long _parsePass();
+    unsigned long long _dispatchPass();
+    unsigned long long _numericPass();
+    unsigned long long _prefixPass();
+    
+    MicroBench(const MicroBench&);
+    MicroBench& operator=(const MicroBench&);
+    
+public:
+    MicroBench(const std::vector<std::string>& lines, double minTime);
+    ~MicroBench();
+    
+    void run();
+    
+    static unsigned long long getAllocationCount();
+};
+
+#endif
@@ -0,0 +1,127 @@
+#include "LoadGenerator.hpp"
+#include <iostream>
+#include <map>
+#include <cstdlib>
+#include <cctype>
+#include <csignal>
+#include <stdexcept>
+
+void printUsage(const std::string& programName) {
+    std::cout << "Usage:" << std::endl;
+    std::cout << "  " << programName << " <port> <password> [options]" << std::endl;
+    std::cout << std::endl;
+    std::cout << "Options:" << std::endl;
+    std::cout << "  --host=<addr>              : Server IPv4 address (default: 127.0.0.1)" << std::endl;
+    std::cout << "  --clients=<n>              : Simulated clients to connect (default: 100)" << std::endl;
+    std::cout << "  --channels=<n>             : Channels in the topology (default: 10)" << std::endl;
+    std::cout << "  --channels-per-client=<n>  : Channels each client joins (default: 1)" << std::endl;
+    std::cout << "  --rate=<n>                 : PRIVMSG sent per second across all clients (default: 1000)" << std::endl;
+    std::cout << "  --duration=<s>             : Seconds to drive load (default: 10)" << std::endl;
+    std::cout << "  --interval=<s>             : Seconds between report lines (default: 1)" << std::endl;
+    std::cout << "  --size=<n>                 : PRIVMSG line length in bytes (default: 64)" << std::endl;
+    std::cout << "  --pid=<n>                  : Server process id to sample RSS from" << std::endl;
+    std::cout << "  --backend=<name>           : Event loop backend: epoll, epoll-et or poll (default: epoll)" << std::endl;
+    std::cout << "  --setup-timeout=<s>        : Seconds allowed for registration and joins (default: 30)" << std::endl;
+    std::cout << std::endl;
+    std::cout << "Notes:" << std::endl;
+    std::cout << "  • Start ircserv with --flood-rate=0 and a --max-clients above --clients" << std::endl;
+    std::cout << "  • Client i joins channels i..i+k-1 (mod --channels), so members per channel stay even" << std::endl;
+}
+
+bool parseNumber(const std::string& str, long& value) {
+    if (str.empty() || str.length() > 9) return false;
+    
+    for (size_t i = 0; i < str.length(); i++) {
+        if (!isdigit(str[i])) return false;
+    }
+    
+    value = strtol(str.c_str(), NULL, 10);
+    return true;
+}
+
+bool applyOption(LoadConfig& config, const std::string& name, const std::string& value) {
+    if (name == "host") {
+        config.host = value;
+        return true;
+    }
+    if (name == "backend") {
+        if (!Poller::isValidBackend(value)) {
+            std::cout << "Error: Unknown backend '" << value << "'." << std::endl;
+            return false;
+        }
+        config.backend = value;
+        return true;
+    }
+    
+    long number;
+    if (!parseNumber(value, number)) {
+        std::cout << "Error: Invalid value for --" << name << ": '" << value << "'." << std::endl;
+        return false;
+    }
+    
+    if (name == "clients" && number >= 1) {
+        config.clients = static_cast<size_t>(number);
+    } else if (name == "channels" && number >= 1) {
+        config.channels = static_cast<size_t>(number);
+    } else if (name == "channels-per-client") {
+        config.channelsPerClient = static_cast<size_t>(number);
+    } else if (name == "rate" && number >= 1) {
+        config.rate = static_cast<double>(number);
+    } else if (name == "duration" && number >= 1) {
+        config.duration = static_cast<double>(number);
+    } else if (name == "interval" && number >= 1) {
+        config.interval = static_cast<double>(number);
+    } else if (name == "size" && number >= 1 && number <= 510) {
+        config.messageSize = static_cast<size_t>(number);
+    } else if (name == "pid" && number >= 1) {
+        config.serverPid = static_cast<int>(number);
+    } else if (name == "setup-timeout" && number >= 1) {
+        config.setupTimeout = static_cast<double>(number);
+    } else {
+        std::cout << "Error: Unknown option or value out of range: --" << name << "=" << value << std::endl;
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        printUsage(argv[0]);
+        return 1;
+    }
+    
+    LoadConfig config;
+    long port;
+    if (!parseNumber(argv[1], port) || port < 1 || port > 65535) {
+        std::cout << "Error: Invalid port '" << argv[1] << "'." << std::endl;
+        return 1;
+    }
+    config.port = static_cast<int>(port);
+    config.password = argv[2];
+    
+    for (int i = 3; i < argc; i++) {
+        std::string arg = argv[i];
+        size_t eq = arg.find('=');
+        
+        if (arg.compare(0, 2, "--") != 0 || eq == std::string::npos || eq == 2) {
+            std::cout << "Error: Malformed option '" << arg << "' (expected --name=value)." << std::endl;
+            printUsage(argv[0]);
+            return 1;
+        }
+        if (!applyOption(config, arg.substr(2, eq - 2), arg.substr(eq + 1))) {
+            return 1;
+        }
+    }
+    
+    signal(SIGPIPE, SIG_IGN);
+    
+    try {
+        LoadGenerator generator(config);
+        generator.run();
+    } catch (const std::exception& e) {
+        std::cout << "Benchmark failed: " << e.what() << std::endl;
+        return 1;
+    }
+    
+    return 0;
+}
@@ -0,0 +1,82 @@
+#include "MicroBench.hpp"
+#include <iostream>
+#include <fstream>
+#include <cstdlib>
+#include <cctype>
+#include <stdexcept>
+
+bool parseNumber(const std::string& str, long& value) {
+    if (str.empty() || str.length() > 9) return false;
+    
+    for (size_t i = 0; i < str.length(); i++) {
+        if (!isdigit(str[i])) return false;
+    }
+    
+    value = strtol(str.c_str(), NULL, 10);
+    return true;
+}
+
+void printUsage(const std::string& programName) {
+    std::cout << "Usage:" << std::endl;
+    std::cout << "  " << programName << " [traffic-file] [options]" << std::endl;
+    std::cout << std::endl;
+    std::cout << "Options:" << std::endl;
+    std::cout << "  --time=<ms>  : Minimum measured time per benchmark (default: 500)" << std::endl;
+    std::cout << std::endl;
+    std::cout << "The traffic file holds one client line per row (default: bench/traffic.irc)." << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    std::string path = "bench/traffic.irc";
+    long timeMs = 500;
+    
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg.compare(0, 7, "--time=") == 0) {
+            if (!parseNumber(arg.substr(7), timeMs) || timeMs < 1) {
+                std::cout << "Error: Invalid value for --time: '" << arg.substr(7) << "'." << std::endl;
+                return 1;
+            }
+        } else if (arg.compare(0, 2, "--") == 0) {
+            printUsage(argv[0]);
+            return 1;
+        } else {
+            path = arg;
+        }
+    }
+    
+    std::ifstream file(path.c_str());
+    if (!file) {
+        std::cout << "Error: Cannot open traffic file '" << path << "'." << std::endl;
+        printUsage(argv[0]);
+        return 1;
+    }
+    
+    std::vector<std::string> lines;
+    std::string line;
+    while (std::getline(file, line)) {
+        if (!line.empty() && line[line.length() - 1] == '\r') {
+            line.erase(line.length() - 1);
+        }
+        if (!line.empty() && line.compare(0, 5, "QUIT ") != 0 && line != "QUIT") {
+            lines.push_back(line);
+        }
+    }
+    
+    if (lines.empty()) {
+        std::cout << "Error: Traffic file '" << path << "' has no usable lines." << std::endl;
+        return 1;
+    }
+    
+    std::cout << "Replaying " << lines.size() << " lines from " << path << std::endl << std::endl;
+    
+    try {
+        MicroBench bench(lines, timeMs / 1000.0);
+        bench.run();
+    } catch (const std::exception& e) {
+        std::cout << "Microbenchmark failed: " << e.what() << std::endl;
+        return 1;
+    }
+    
+    return 0;
+}
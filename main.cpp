@@ -3,6 +3,7 @@
 #include <cstdlib>
 #include <limits>
 #include <new>
+#include <map>
 
 void printBanner() {
     std::cout << BOLD << CYAN << std::endl;
@@ -24,12 +25,31 @@ void printBanner() {
 
 void printUsage(const std::string& programName) {
     std::cout << BOLD << "Usage:" << RESET << std::endl;
-    std::cout << "  " << CYAN << programName << " <port> <password>" << RESET << std::endl;
+    std::cout << "  " << CYAN << programName << " <port> <password> [options]" << RESET << std::endl;
     std::cout << std::endl;
     std::cout << BOLD << "Parameters:" << RESET << std::endl;
     std::cout << "  " << YELLOW << "port" << RESET << "     : The port number (1-65535) on which the IRC server will listen" << std::endl;
     std::cout << "  " << YELLOW << "password" << RESET << " : The connection password required by IRC clients" << std::endl;
     std::cout << std::endl;
+    std::cout << BOLD << "Options:" << RESET << std::endl;
+    std::cout << "  " << YELLOW << "--backend=<name>" << RESET << "  : Event loop backend: epoll, epoll-et, poll or io_uring (default: epoll on Linux)" << std::endl;
+    std::cout << "  " << YELLOW << "--casemapping=<name>" << RESET << " : Nick/channel case mapping: rfc1459 or ascii (default: rfc1459)" << std::endl;
+    std::cout << "  " << YELLOW << "--threads=<n>" << RESET << "     : Reactor threads, each with its own listener and clients (default: 1)" << std::endl;
+    std::cout << "  " << YELLOW << "--max-clients=<n>" << RESET << " : Simultaneous connections allowed (default: 100)" << std::endl;
+    std::cout << "  " << YELLOW << "--accept-batch=<n>" << RESET << " : Connections accepted per loop iteration (default: 64)" << std::endl;
+    std::cout << "  " << YELLOW << "--listen-backlog=<n>" << RESET << " : Pending connection queue length (default: SOMAXCONN)" << std::endl;
+    std::cout << "  " << YELLOW << "--sendq-<class>=<n>" << RESET << " : Output queue limit in bytes for unregistered, user or oper (default: 32768, 1048576, 4194304)" << std::endl;
+    std::cout << "  " << YELLOW << "--registration-timeout=<s>" << RESET << " : Seconds a connection may take to register (default: 30)" << std::endl;
+    std::cout << "  " << YELLOW << "--ping-interval=<s>" << RESET << " : Idle seconds before the server sends PING (default: 120)" << std::endl;
+    std::cout << "  " << YELLOW << "--ping-timeout=<s>" << RESET << " : Seconds to wait for any reply to PING (default: 60)" << std::endl;
+    std::cout << "  " << YELLOW << "--flood-burst=<n>" << RESET << " : Commands a client may send back-to-back (default: 20)" << std::endl;
+    std::cout << "  " << YELLOW << "--flood-rate=<n>" << RESET << "  : Commands per second refilled afterwards, 0 disables (default: 10)" << std::endl;
+    std::cout << "  " << YELLOW << "--metrics-port=<n>" << RESET << " : Serve Prometheus metrics at http://127.0.0.1:<n>/metrics (default: off)" << std::endl;
+    std::cout << "  " << YELLOW << "--log-level=<name>" << RESET << " : Minimum level logged: debug, info, warning or error; info hides per-message echo (default: debug)" << std::endl;
+    std::cout << "  " << YELLOW << "--log-file=<path>" << RESET << " : Also append log records to this file" << std::endl;
+    std::cout << "  " << YELLOW << "--log-max-size=<n>" << RESET << " : Bytes before the log file is rotated, 0 disables (default: 10485760)" << std::endl;
+    std::cout << "  " << YELLOW << "--log-files=<n>" << RESET << "   : Rotated log files kept as <path>.1 to <path>.n (default: 5)" << std::endl;
+    std::cout << std::endl;
     std::cout << BOLD << "Examples:" << RESET << std::endl;
     std::cout << "  " << CYAN << programName << " 6667 mypassword" << RESET << std::endl;
     std::cout << "  " << CYAN << programName << " 8080 \"secret password\"" << RESET << std::endl;
@@ -67,6 +87,148 @@ bool isValidPassword(const std::string& password) {
     return true;
 }
 
+bool parseNumber(const std::string& str, long& value) {
+    if (str.empty() || str.length() > 9) return false;
+    
+    for (size_t i = 0; i < str.length(); i++) {
+        if (!isdigit(str[i])) return false;
+    }
+    
+    value = strtol(str.c_str(), NULL, 10);
+    return true;
+}
+
+bool parseOptions(int argc, char* argv[], std::map<std::string, std::string>& options) {
+    for (int i = 3; i < argc; i++) {
+        std::string arg = argv[i];
+        size_t eq = arg.find('=');
+        
+        if (arg.compare(0, 2, "--") != 0 || eq == std::string::npos || eq == 2) {
+            std::cout << RED << "Error: Malformed option '" << arg << "' (expected --name=value)." << RESET << std::endl;
+            return false;
+        }
+        
+        options[arg.substr(2, eq - 2)] = arg.substr(eq + 1);
+    }
+    return true;
+}
+
+bool applyOptions(Server* server, const std::map<std::string, std::string>& options) {
+    for (std::map<std::string, std::string>::const_iterator it = options.begin(); it != options.end(); ++it) {
+        const std::string& name = it->first;
+        const std::string& value = it->second;
+        
+        if (name == "backend") {
+            if (!Poller::isValidBackend(value)) {
+                std::cout << RED << "Error: Unknown backend '" << value << "' (use epoll, epoll-et, poll or io_uring)." << RESET << std::endl;
+                return false;
+            }
+            server->setPollBackend(value);
+        } else if (name == "threads") {
+            long count;
+            if (!parseNumber(value, count) || count < 1 || count > 64) {
+                std::cout << RED << "Error: Invalid value for --threads: '" << value << "' (use 1 to 64)." << RESET << std::endl;
+                return false;
+            }
+            server->setReactorCount(static_cast<size_t>(count));
+        } else if (name == "registration-timeout" || name == "ping-interval" || name == "ping-timeout") {
+            long seconds;
+            if (!parseNumber(value, seconds) || seconds < 1 || seconds > 86400) {
+                std::cout << RED << "Error: Invalid value for --" << name << ": '" << value << "' (use 1 to 86400 seconds)." << RESET << std::endl;
+                return false;
+            }
+            if (name == "registration-timeout") {
+                server->setRegistrationTimeout(static_cast<unsigned int>(seconds));
+            } else if (name == "ping-interval") {
+                server->setPingInterval(static_cast<unsigned int>(seconds));
+            } else {
+                server->setPingTimeout(static_cast<unsigned int>(seconds));
+            }
+        } else if (name == "max-clients") {
+            long count;
+            if (!parseNumber(value, count) || count < 1 || count > 1000000) {
+                std::cout << RED << "Error: Invalid value for --max-clients: '" << value << "' (use 1 to 1000000)." << RESET << std::endl;
+                return false;
+            }
+            server->setMaxClients(static_cast<size_t>(count));
+        } else if (name == "accept-batch" || name == "listen-backlog") {
+            long amount;
+            if (!parseNumber(value, amount) || amount < 1 || amount > 65535) {
+                std::cout << RED << "Error: Invalid value for --" << name << ": '" << value << "' (use 1 to 65535)." << RESET << std::endl;
+                return false;
+            }
+            if (name == "accept-batch") {
+                server->setAcceptBatch(static_cast<size_t>(amount));
+            } else {
+                server->setListenBacklog(static_cast<int>(amount));
+            }
+        } else if (name.compare(0, 6, "sendq-") == 0) {
+            long bytes;
+            if (!parseNumber(value, bytes) || bytes < 512) {
+                std::cout << RED << "Error: Invalid value for --" << name << ": '" << value << "' (minimum 512 bytes)." << RESET << std::endl;
+                return false;
+            }
+            if (!server->setSendQLimit(name.substr(6), static_cast<size_t>(bytes))) {
+                std::cout << RED << "Error: Unknown connection class in --" << name << " (use unregistered, user or oper)." << RESET << std::endl;
+                return false;
+            }
+        } else if (name == "flood-burst" || name == "flood-rate") {
+            long amount;
+            if (!parseNumber(value, amount) || (name == "flood-burst" && amount < 1)) {
+                std::cout << RED << "Error: Invalid value for --" << name << ": '" << value << "'." << RESET << std::endl;
+                return false;
+            }
+            if (name == "flood-burst") {
+                server->setFloodBurst(static_cast<double>(amount));
+            } else {
+                server->setFloodRate(static_cast<double>(amount));
+            }
+        } else if (name == "metrics-port") {
+            long port;
+            if (!parseNumber(value, port) || port < 1 || port > 65535) {
+                std::cout << RED << "Error: Invalid value for --metrics-port: '" << value << "' (use 1 to 65535)." << RESET << std::endl;
+                return false;
+            }
+            server->setMetricsPort(static_cast<int>(port));
+        } else if (name == "log-level") {
+            LogLevel level;
+            if (!Logger::parseLevel(value, level)) {
+                std::cout << RED << "Error: Unknown log level '" << value << "' (use debug, info, warning or error)." << RESET << std::endl;
+                return false;
+            }
+            server->getLogger().setLevel(level);
+        } else if (name == "log-file") {
+            if (value.empty()) {
+                std::cout << RED << "Error: --log-file needs a path." << RESET << std::endl;
+                return false;
+            }
+            server->getLogger().setFile(value);
+        } else if (name == "log-max-size" || name == "log-files") {
+            long amount;
+            if (!parseNumber(value, amount) || (name == "log-files" && amount > 100)) {
+                std::cout << RED << "Error: Invalid value for --" << name << ": '" << value << "'." << RESET << std::endl;
+                return false;
+            }
+            if (name == "log-max-size") {
+                server->getLogger().setMaxFileSize(static_cast<size_t>(amount));
+            } else {
+                server->getLogger().setMaxFiles(static_cast<unsigned int>(amount));
+            }
+        } else if (name == "casemapping") {
+            CaseMapping mapping;
+            if (!parseCaseMapping(value, mapping)) {
+                std::cout << RED << "Error: Unknown casemapping '" << value << "' (use rfc1459 or ascii)." << RESET << std::endl;
+                return false;
+            }
+            server->setCaseMapping(mapping);
+        } else {
+            std::cout << RED << "Error: Unknown option '--" << name << "'." << RESET << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
 void printServerInfo() {
     std::cout << BOLD << "\nServer Features:" << RESET << std::endl;
     std::cout << "  • " << MAGENTA << "Multi-client support with non-blocking I/O" << RESET << std::endl;
@@ -90,7 +252,7 @@ int main(int argc, char* argv[]) {
         return 0;
     }
     
-    if (argc != 3) {
+    if (argc < 3) {
         std::cout << RED << "Error: Invalid number of arguments! Chouf chwya lte7t wakha? <3" << RESET << std::endl << std::endl;
         printUsage(argv[0]);
         return 1;
@@ -118,6 +280,12 @@ int main(int argc, char* argv[]) {
         return 1;
     }
     
+    std::map<std::string, std::string> options;
+    if (!parseOptions(argc, argv, options)) {
+        printUsage(argv[0]);
+        return 1;
+    }
+    
     int port = atoi(portStr.c_str());
     
     if (port < 1024) {
@@ -141,6 +309,11 @@ int main(int argc, char* argv[]) {
             return 1;
         }
         
+        if (!applyOptions(server, options)) {
+            delete server;
+            return 1;
+        }
+        
         std::cout << GREEN << "Server initialized successfully!" << RESET << std::endl;
         std::cout << "Ready to accept connections..." << std::endl;
         std::cout << std::endl;